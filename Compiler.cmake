@@ -11,6 +11,10 @@ ENDIF(NOT CMAKE_CONFIGURATION_TYPES AND NOT CMAKE_BUILD_TYPE)
 set(CMAKE_CXX_STANDARD 17)
 
 option(BUILD_PROFILING "Build with profiling options" OFF)
+option(IVP_TRACING "Record a timeline of steps, attempts and evaluations (see methods/trace.h)" OFF)
+if (${IVP_TRACING})
+    add_compile_definitions(IVP_TRACING)
+endif()
 
 
 # Select flags.
@@ -8,6 +8,9 @@
 #	list(APPEND svg_cpp_plot_defs "USE_PNG")
 #endif(PNG_FOUND)
 
+find_package(Threads REQUIRED)
+find_package(Eigen3 3.3 QUIET NO_MODULE)
+
 ######################################################################
 # EXTERNAL LIBRARIES (GitHub etc...
 ######################################################################
@@ -1,5 +1,6 @@
 #include "methods/method.h"
 #include "methods/problem.h"
+#include "methods/state.h"
 
 #include "methods/euler.h"
 #include "methods/runge-kutta-2.h"
@@ -10,6 +11,28 @@
 #include "methods/embedded-runge-kutta-2.h"
 #include "methods/bogacki-shampine.h"
 #include "methods/dopri.h"
+#include "methods/mixed-precision.h"
+#include "methods/async.h"
+#include "methods/sensitivity.h"
+#include "methods/adjoint.h"
+#include "methods/dual.h"
+#include "methods/jacobian.h"
+#include "methods/implicit-solver.h"
+#include "methods/delay.h"
+#include "methods/second-order.h"
+#include "methods/stormer-verlet.h"
+#include "methods/runge-kutta-nystrom.h"
+#include "methods/additive-runge-kutta.h"
+#include "methods/splitting.h"
+#include "methods/thread-pool.h"
+#include "methods/bulirsch-stoer.h"
+#include "methods/any-solver.h"
+#include "methods/autotune.h"
+#include "methods/integrator.h"
+#include "methods/real-time.h"
+#include "methods/tabulated.h"
+#include "methods/stochastic.h"
+#include "methods/multiple-shooting.h"
 //Deprecated
 //#include "adaptive-runge-kutta-2.h"
 
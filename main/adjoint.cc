@@ -0,0 +1,113 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cmath>
+#include <chrono>
+
+#include "operators.h"
+#include <ivp.h>
+
+/* Gradient of L = |y(10)|^2/2 for y_i' = -p_i y_i + sin(y_(i-1))/2 + cos(t), with as many parameters as
+ * elements (100), through the adjoint with different snapshot budgets and through forward sensitivities.
+ */
+using Vector = std::vector<double>;
+const std::size_t n = 100;
+const std::size_t steps = 1000;
+Vector p;
+
+struct Chain
+{
+        Vector operator()(double t, const Vector& y) const
+        {
+                Vector sol(y.size());
+                for (std::size_t i = 0; i<y.size(); ++i) sol[i] = -p[i]*y[i] + ((i>0)?0.5*std::sin(y[i-1]):0.0) + std::cos(t);
+                return sol;
+        }
+};
+
+//df/dy^T lambda
+struct ChainVjpY
+{
+        Vector operator()(double t, const Vector& y, const Vector& l) const
+        {
+                Vector sol(y.size());
+                for (std::size_t i = 0; i<y.size(); ++i) sol[i] = -p[i]*l[i] + ((i+1<y.size())?0.5*std::cos(y[i])*l[i+1]:0.0);
+                return sol;
+        }
+};
+
+//df/dp^T lambda
+struct ChainVjpP
+{
+        Vector operator()(double t, const Vector& y, const Vector& l) const
+        {
+                Vector sol(y.size());
+                for (std::size_t i = 0; i<y.size(); ++i) sol[i] = -y[i]*l[i];
+                return sol;
+        }
+};
+
+//df/dy, as an operator on the sensitivity columns
+struct ChainJacobian
+{
+        Vector y;
+        friend Vector operator*(const ChainJacobian& j, const Vector& v)
+        {
+                Vector sol(v.size());
+                for (std::size_t i = 0; i<v.size(); ++i) sol[i] = -p[i]*v[i] + ((i>0)?0.5*std::cos(j.y[i-1])*v[i-1]:0.0);
+                return sol;
+        }
+};
+
+struct ChainDfdy { ChainJacobian operator()(double t, const Vector& y) const { return ChainJacobian{y}; } };
+
+struct ChainDfdp
+{
+        std::vector<Vector> operator()(double t, const Vector& y) const
+        {
+                std::vector<Vector> sol(y.size(),Vector(y.size(),0.0));
+                for (std::size_t j = 0; j<y.size(); ++j) sol[j][j] = -y[j];
+                return sol;
+        }
+};
+
+template<typename F>
+double seconds(const F& f)
+{
+        std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+        f();
+        return std::chrono::duration<double>(std::chrono::system_clock::now() - start).count();
+}
+
+int main(int argc, char** argv)
+{
+        for (std::size_t i = 0; i<n; ++i) p.push_back(0.5 + double(i)/double(n));
+        Vector y0(n,1.0);
+        IVP::RungeKutta4 rk4(static_cast<int>(steps));
+
+        Vector y;
+        double forward = seconds([&] () { y = rk4.solve(Chain(),0.0,y0,10.0); });
+
+        Vector reference(n,0.0);
+        double sensitivity = seconds([&] () {
+                auto s = rk4.solve(IVP::forward_sensitivity(Chain(),ChainDfdy(),ChainDfdp()),0.0,IVP::sensitivity_state(y0,n),10.0);
+                for (std::size_t j = 0; j<n; ++j) for (std::size_t i = 0; i<n; ++i) reference[j] += s.y[i]*s.s[j][i]; });
+
+        std::cout<<"RK4, "<<steps<<" steps, "<<n<<" elements, "<<n<<" parameters"<<std::endl;
+        std::cout<<std::fixed<<std::setprecision(2);
+        std::cout<<"\t forward solve          "<<std::setw(9)<<1.e3*forward<<"ms"<<std::endl;
+        std::cout<<"\t forward sensitivity    "<<std::setw(9)<<1.e3*sensitivity<<"ms\t"<<std::setw(7)<<sensitivity/forward<<"x"<<std::endl;
+        std::cout<<"\t adjoint"<<std::endl;
+        std::cout<<"\t snapshots \t time \t\t\t forward steps \t error"<<std::endl;
+        for (unsigned int s : { 0u, 1u, 2u, 4u, 8u, 16u, unsigned(steps) })
+        {
+                if ((s == 0) && (steps>100)) continue; //Quadratic
+                IVP::AdjointSolution<Vector,Vector> g;
+                auto adjoint = IVP::adjoint(rk4,steps,s);
+                double t = seconds([&] () { g = adjoint.gradient(Chain(),ChainVjpY(),ChainVjpP(),0.0,y0,10.0,[] (const Vector& y) { return y; }); });
+                double error = 0.0;
+                for (std::size_t j = 0; j<n; ++j) error = std::max(error,std::fabs(g.gradient[j] - reference[j]));
+                std::cout<<"\t "<<std::setw(9)<<g.peak_snapshots<<"\t"<<std::setw(9)<<1.e3*t<<"ms "<<std::setw(7)<<t/forward<<"x\t"
+                         <<std::setw(9)<<g.forward_steps<<"\t"<<std::scientific<<error<<std::fixed<<std::endl;
+        }
+}
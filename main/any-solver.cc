@@ -0,0 +1,76 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cmath>
+#include <chrono>
+
+#include "operators.h"
+#include <ivp.h>
+
+/* Methods chosen at runtime through AnySolver (taken from the ivp-any-solver library):
+ *   any-solver [method [steps [tolerance]]]
+ * solves the Arenstorf orbit with the given method (or with all of them), and then compares the time per step
+ * of RungeKutta4 on y' = -y called directly, through AnySolver with a std::function and through AnySolver
+ * with the type of the function.
+ */
+std::vector<double> arenstorf(double t, const std::vector<double>& y)
+{
+        const double mu = 0.012277471, nu = 1.0 - mu;
+        double d1 = std::pow((y[0] + mu)*(y[0] + mu) + y[1]*y[1],1.5);
+        double d2 = std::pow((y[0] - nu)*(y[0] - nu) + y[1]*y[1],1.5);
+        return std::vector<double>{ y[2], y[3],
+                y[0] + 2.0*y[3] - nu*(y[0] + mu)/d1 - mu*(y[0] - nu)/d2,
+                y[1] - 2.0*y[2] - nu*y[1]/d1 - mu*y[1]/d2 };
+}
+
+struct Decay
+{
+        double operator()(double t, const double& y) const { return -y; }
+};
+
+template<typename F>
+double seconds(const F& f)
+{
+        std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+        f();
+        return std::chrono::duration<double>(std::chrono::system_clock::now() - start).count();
+}
+
+void run(const IVP::AnySolver<std::vector<double>>& solver)
+{
+        const double period = 17.0652165601579625588917206249;
+        std::vector<double> y_ini{ 0.994, 0.0, 0.0, -2.00158510637908252240537862224 }, y;
+        std::size_t steps = 0;
+        double t = seconds([&] () { steps = solver.steps(arenstorf,0.0,y_ini,period,[&y] (double t, const std::vector<double>& s) { y = s; }); });
+        double error = 0.0;
+        for (std::size_t i = 0; i<y.size(); ++i) error = std::max(error,std::fabs(y[i] - y_ini[i]));
+        std::cout<<"\t "<<std::left<<std::setw(32)<<solver.name()<<std::right<<std::scientific<<std::setprecision(2)<<error<<"\t"
+                 <<std::setw(8)<<steps<<"\t"<<std::fixed<<std::setw(9)<<1.e3*t<<"ms"<<std::endl;
+}
+
+int main(int argc, char** argv)
+{
+        unsigned int steps = (argc>2)?std::stoul(argv[2]):10000;
+        double tolerance = (argc>3)?std::stod(argv[3]):1.e-7;
+        std::cout<<"Arenstorf orbit, one period ("<<steps<<" steps, tolerance "<<std::scientific<<std::setprecision(0)<<tolerance
+                 <<")\t error \t\t steps \t\t time"<<std::endl;
+        try
+        {
+                if (argc>1) run(IVP::any_solver<std::vector<double>>(argv[1],steps,tolerance));
+                else for (const std::string& method : IVP::any_solver_methods())
+                        run(IVP::any_solver<std::vector<double>>(method,method.find("euler")==std::string::npos?steps:10*steps,tolerance));
+        }
+        catch (const std::invalid_argument& e) { std::cerr<<e.what()<<std::endl; return 1; }
+
+        const unsigned int n = 10000000;
+        double direct, erased, typed;
+        double t_direct = seconds([&] () { direct = IVP::RungeKutta4(int(n)).solve(Decay(),0.0,1.0,1.0); });
+        IVP::AnySolver<double> any = IVP::any_solver<double>("runge-kutta-4",n);
+        double t_erased = seconds([&] () { erased = any.solve(Decay(),0.0,1.0,1.0); });
+        IVP::AnySolver<double,Decay> any_typed = IVP::AnySolver<double,Decay>(IVP::RungeKutta4(int(n)));
+        double t_typed = seconds([&] () { typed = any_typed.solve(Decay(),0.0,1.0,1.0); });
+        std::cout<<std::endl<<"RungeKutta4, y' = -y, "<<n<<" steps \t result \t ns/step"<<std::endl<<std::setprecision(2);
+        std::cout<<"\t direct                    \t"<<std::setprecision(12)<<direct<<"\t"<<std::setprecision(2)<<1.e9*t_direct/n<<std::endl;
+        std::cout<<"\t AnySolver (std::function) \t"<<std::setprecision(12)<<erased<<"\t"<<std::setprecision(2)<<1.e9*t_erased/n<<std::endl;
+        std::cout<<"\t AnySolver<double,Decay>   \t"<<std::setprecision(12)<<typed<<"\t"<<std::setprecision(2)<<1.e9*t_typed/n<<std::endl;
+}
@@ -0,0 +1,59 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cmath>
+#include <chrono>
+#include <thread>
+
+#include "operators.h"
+#include <ivp.h>
+
+/* Integration overlapped with post-processing: the same steps consumed on the integrating thread (steps) and
+ * on a separate thread (async_steps). The post-processing stands for statistics, rendering or writing.
+ */
+const std::size_t n = 10000;
+
+struct Problem
+{
+        std::vector<double> operator()(double t, const std::vector<double>& y) const
+        {
+                std::vector<double> sol(y.size());
+                for (std::size_t i = 0; i<y.size(); ++i) sol[i] = -(1.0 + double(i)/double(y.size()))*(y[i] - std::cos(t));
+                return sol;
+        }
+};
+
+double post_process(const std::vector<double>& y)
+{
+        double sol = 0.0;
+        for (int r = 0; r<20; ++r) for (double v : y) sol += std::sqrt(std::fabs(v));
+        return sol;
+}
+
+template<typename F>
+double seconds(const F& f)
+{
+        std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+        f();
+        return std::chrono::duration<double>(std::chrono::system_clock::now() - start).count();
+}
+
+int main(int argc, char** argv)
+{
+        IVP::Dopri dopri(2000);
+        std::vector<double> y0(n,1.0);
+        double checksum_sync = 0.0, checksum_async = 0.0;
+
+        double integration = seconds([&] () { dopri.solve(Problem(), 0.0, y0, 10.0); });
+        double sync = seconds([&] () {
+                for (const auto& s : dopri.steps(Problem(), 0.0, y0, 10.0)) checksum_sync += post_process(s.y()); });
+        double async = seconds([&] () {
+                for (const auto& s : IVP::async_steps(dopri, Problem(), 0.0, y0, 10.0, 64)) checksum_async += post_process(s.y()); });
+
+        std::cout<<"Dopri, 2000 steps, "<<n<<" elements, "<<std::thread::hardware_concurrency()<<" hardware threads"<<std::endl;
+        std::cout<<std::fixed<<std::setprecision(2);
+        std::cout<<"\t integration only "<<std::setw(9)<<1.e3*integration<<"ms"<<std::endl;
+        std::cout<<"\t steps            "<<std::setw(9)<<1.e3*sync<<"ms"<<std::endl;
+        std::cout<<"\t async_steps      "<<std::setw(9)<<1.e3*async<<"ms"<<std::endl;
+        std::cout<<"\t same results     "<<((checksum_sync==checksum_async)?"yes":"no")<<std::endl;
+}
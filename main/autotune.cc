@@ -0,0 +1,75 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cmath>
+#include <chrono>
+#include <filesystem>
+
+#include "operators.h"
+#include <ivp.h>
+
+/* Autotuning (with the methods of the ivp-any-solver library):
+ *   autotune [cache file]
+ * tunes three problems for two accuracy targets, and then does it again with a new Autotuner that loads the
+ * cache file, so that nothing is calibrated. Run it twice and the first pass takes no calibration either.
+ */
+std::vector<double> arenstorf(double t, const std::vector<double>& y)
+{
+        const double mu = 0.012277471, nu = 1.0 - mu;
+        double d1 = std::pow((y[0] + mu)*(y[0] + mu) + y[1]*y[1],1.5);
+        double d2 = std::pow((y[0] - nu)*(y[0] - nu) + y[1]*y[1],1.5);
+        return std::vector<double>{ y[2], y[3],
+                y[0] + 2.0*y[3] - nu*(y[0] + mu)/d1 - mu*(y[0] - nu)/d2,
+                y[1] - 2.0*y[2] - nu*y[1]/d1 - mu*y[1]/d2 };
+}
+
+std::vector<double> van_der_pol(double t, const std::vector<double>& y)
+{       return std::vector<double>{ y[1], 5.0*(1.0 - y[0]*y[0])*y[1] - y[0] }; }
+
+double decay(double t, const double& y) { return -2.0*y + std::sin(t); }
+
+template<typename F>
+double seconds(const F& f)
+{
+        std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+        f();
+        return std::chrono::duration<double>(std::chrono::system_clock::now() - start).count();
+}
+
+template<typename YType>
+void tune(IVP::Autotuner& tuner, const char* problem, YType (*f)(double, const YType&), double b, const YType& y_ini, double target)
+{
+        IVP::TunedSolver tuned;
+        double calibration = seconds([&] () { tuned = tuner.tune<YType>(problem,f,0.0,y_ini,b,target); });
+        std::cout<<"\t "<<std::left<<std::setw(12)<<problem<<std::right<<std::scientific<<std::setprecision(0)<<target<<"\t";
+        if (tuned.valid())
+                std::cout<<std::left<<std::setw(28)<<tuned.method<<std::right<<std::setw(6)<<tuned.steps<<"  "<<tuned.tolerance<<"\t"
+                         <<std::setprecision(2)<<tuned.error<<"\t"<<std::fixed<<std::setw(8)<<1.e3*tuned.seconds<<"ms\t"
+                         <<std::setw(8)<<1.e3*calibration<<"ms"<<std::endl;
+        else std::cout<<"none"<<std::endl;
+}
+
+void tune_all(IVP::Autotuner& tuner)
+{
+        std::cout<<"\t problem \t target\tmethod \t\t\t      steps  tol.  \terror   \t    solve \tcalibration"<<std::endl;
+        for (double target : { 1.e-4, 1.e-8 })
+        {
+                tune(tuner,"arenstorf",arenstorf,17.0652165601579625588917206249,
+                     std::vector<double>{ 0.994, 0.0, 0.0, -2.00158510637908252240537862224 },target);
+                tune(tuner,"van-der-pol",van_der_pol,10.0,std::vector<double>{ 2.0, 0.0 },target);
+                tune(tuner,"decay",decay,10.0,1.0,target);
+        }
+}
+
+int main(int argc, char** argv)
+{
+        std::string cache = (argc>1)?argv[1]:(std::filesystem::temp_directory_path()/"ivp-autotune.cache").string();
+        std::cout<<"Cache: "<<cache<<std::endl;
+        {
+                IVP::Autotuner tuner(cache);
+                tune_all(tuner);
+        }
+        std::cout<<"Again, from the cache"<<std::endl;
+        IVP::Autotuner tuner(cache);
+        tune_all(tuner);
+}
@@ -0,0 +1,80 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <utility>
+
+#include <ivp.h>
+
+/* Copies of the state along a solve: Euler on y' = -y with 10^6 elements, where copying the state costs about as
+ * much as the step itself. Field counts its copies (not its moves, nor the new states of the arithmetic), so the
+ * traffic per step is what the solve path adds on top of the method.
+ *   - the loop that solve used to be: for (auto s : steps(...)) y = s.y();
+ *   - solve with an lvalue (one copy per solve), an rvalue (none), and solve_inplace (none).
+ */
+struct Field
+{
+        static std::size_t copied; //bytes
+        std::vector<double> v;
+
+        explicit Field(std::size_t n = 0, double x = 0.0) : v(n,x) { }
+        Field(const Field& that) : v(that.v) { copied += sizeof(double)*v.size(); }
+        Field(Field&& that) = default;
+        Field& operator=(const Field& that) { v = that.v; copied += sizeof(double)*v.size(); return *this; }
+        Field& operator=(Field&& that) = default;
+};
+std::size_t Field::copied = 0;
+
+Field operator+(const Field& a, const Field& b)
+{       Field sol(a.v.size()); for (std::size_t i = 0; i<a.v.size(); ++i) sol.v[i] = a.v[i] + b.v[i]; return sol; }
+
+Field operator*(double s, const Field& a)
+{       Field sol(a.v.size()); for (std::size_t i = 0; i<a.v.size(); ++i) sol.v[i] = s*a.v[i]; return sol; }
+
+struct Decay
+{
+        Field operator()(double t, const Field& y) const { return -1.0*y; }
+};
+
+const unsigned int steps = 50;
+
+template<typename F>
+void measure(const char* id, const F& solve)
+{
+        Field::copied = 0;
+        auto start = std::chrono::steady_clock::now();
+        double y = solve();
+        double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout<<"\t "<<std::left<<std::setw(30)<<id<<std::right<<std::fixed<<std::setprecision(2)
+                 <<std::setw(8)<<double(Field::copied)/(1024.0*1024.0*steps)<<" MB\t"
+                 <<std::setw(8)<<1.e3*t/steps<<" ms\t"<<std::setprecision(6)<<y<<std::endl;
+}
+
+int main()
+{
+        const std::size_t n = 1000000;
+        const IVP::Euler euler = IVP::Euler(int(steps));
+        std::cout<<"Euler, y' = -y, "<<n<<" elements, "<<steps<<" steps\t copied/step\t time/step\t y(1)"<<std::endl;
+        measure("copying loop (old solve)",[&] ()
+        {
+                Field y_ini(n,1.0), y;
+                for (auto s : euler.steps(Decay(),0.0,y_ini,1.0)) { y = s.y(); }
+                return y.v[0];
+        });
+        measure("solve(f,a,y,b)",[&] ()
+        {
+                Field y_ini(n,1.0);
+                return euler.solve(Decay(),0.0,y_ini,1.0).v[0];
+        });
+        measure("solve(f,a,std::move(y),b)",[&] ()
+        {
+                Field y_ini(n,1.0);
+                return euler.solve(Decay(),0.0,std::move(y_ini),1.0).v[0];
+        });
+        measure("solve_inplace(f,a,y,b)",[&] ()
+        {
+                Field y(n,1.0);
+                euler.solve_inplace(Decay(),0.0,y,1.0);
+                return y.v[0];
+        });
+}
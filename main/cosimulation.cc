@@ -0,0 +1,70 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cmath>
+#include <chrono>
+
+#include "operators.h"
+#include <ivp.h>
+
+/* A co-simulation that needs the state at the end of every time slice: Arenstorf orbit over one period with
+ * Adaptive<Dopri>, either restarting a solve for each slice (which warms up again and shortens the last step at
+ * every boundary) or advancing one Integrator, which takes its natural steps and interpolates at the boundaries.
+ */
+const double mu = 0.012277471, nu = 1.0 - mu;
+std::size_t evaluations = 0;
+
+std::vector<double> arenstorf(double t, const std::vector<double>& y)
+{
+        ++evaluations;
+        double d1 = std::pow((y[0] + mu)*(y[0] + mu) + y[1]*y[1],1.5);
+        double d2 = std::pow((y[0] - nu)*(y[0] - nu) + y[1]*y[1],1.5);
+        return std::vector<double>{ y[2], y[3],
+                y[0] + 2.0*y[3] - nu*(y[0] + mu)/d1 - mu*(y[0] - nu)/d2,
+                y[1] - 2.0*y[2] - nu*y[1]/d1 - mu*y[1]/d2 };
+}
+
+template<typename F>
+double seconds(const F& f)
+{
+        std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+        f();
+        return std::chrono::duration<double>(std::chrono::system_clock::now() - start).count();
+}
+
+void report(const char* id, double t, const std::vector<double>& y, const std::vector<double>& reference)
+{
+        double error = 0.0;
+        for (std::size_t i = 0; i<y.size(); ++i) error = std::max(error,std::fabs(y[i] - reference[i]));
+        std::cout<<"\t "<<std::left<<std::setw(12)<<id<<std::right<<std::setw(10)<<evaluations<<"\t"<<std::fixed
+                 <<std::setprecision(2)<<std::setw(8)<<1.e3*t<<"ms\t"<<std::scientific<<error<<std::endl;
+}
+
+int main()
+{
+        const double period = 17.0652165601579625588917206249, tolerance = 1.e-8;
+        const std::vector<double> y_ini{ 0.994, 0.0, 0.0, -2.00158510637908252240537862224 };
+        const IVP::Adaptive<IVP::Dopri> dopri(1,tolerance);
+        const std::vector<double> reference = IVP::BulirschStoer(1000,1.e-13).solve(arenstorf,0.0,y_ini,period);
+
+        for (unsigned int slices : { 100, 1000, 10000 })
+        {
+                std::cout<<slices<<" slices \t\t evaluations \t time \t\t error at the end"<<std::endl;
+                std::vector<double> y = y_ini;
+                evaluations = 0;
+                double t = seconds([&] ()
+                {
+                        for (unsigned int k = 0; k<slices; ++k)
+                                dopri.solve_inplace(arenstorf,period*double(k)/slices,y,period*double(k + 1)/slices);
+                });
+                report("restart",t,y,reference);
+
+                evaluations = 0;
+                t = seconds([&] ()
+                {
+                        auto integrator = IVP::integrator(dopri,arenstorf,0.0,y_ini,period);
+                        for (unsigned int k = 1; k<=slices; ++k) y = integrator.advance_to(period*double(k)/slices);
+                });
+                report("Integrator",t,y,reference);
+        }
+}
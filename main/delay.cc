@@ -0,0 +1,60 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cmath>
+#include <chrono>
+
+#include "operators.h"
+#include <ivp.h>
+
+/* y'(t) = -y(t-1), y(t) = 1 for t <= 0, whose exact solution on [n-1,n] is sum_{k=0..n} (-1)^k (t-k+1)^k/k!.
+ * Convergence of RK4 and Adaptive<Dopri> through Delay, and cost and memory against the integration length.
+ */
+double exact(double t)
+{
+        double sol = 0.0, factorial = 1.0;
+        for (int k = 0; k<=int(std::ceil(t)); ++k)
+        {
+                if (k>0) factorial *= double(k);
+                sol += ((k%2)?-1.0:1.0)*std::pow(t - double(k) + 1.0,k)/factorial;
+        }
+        return sol;
+}
+
+template<typename F>
+double seconds(const F& f)
+{
+        std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+        f();
+        return std::chrono::duration<double>(std::chrono::system_clock::now() - start).count();
+}
+
+int main(int argc, char** argv)
+{
+        auto dde = IVP::delay_problem([] (double t, double y, const auto& lag) { return -lag(t - 1.0); },
+                                      [] (double t) { return 1.0; }, 1.0);
+
+        std::cout<<"y'(t) = -y(t-1), error at t = 10"<<std::endl;
+        for (int steps : { 10, 20, 40, 80, 160 })
+        {
+                auto rk4 = IVP::delay(IVP::RungeKutta4(steps));
+                std::cout<<"\t RK4 "<<std::setw(4)<<steps<<" steps\t"<<std::scientific<<std::setprecision(2)
+                         <<std::fabs(rk4.solve(dde,0.0,1.0,10.0) - exact(10.0))<<std::endl;
+        }
+        for (double tol : { 1.e-4, 1.e-6, 1.e-8 })
+        {
+                auto dopri = IVP::delay(IVP::Adaptive<IVP::Dopri>(100,tol));
+                std::cout<<"\t Adaptive<Dopri> "<<tol<<"\t"<<std::fabs(dopri.solve(dde,0.0,1.0,10.0) - exact(10.0))<<std::endl;
+        }
+
+        std::cout<<"Constant step 0.01, cost and history against the integration length"<<std::endl;
+        for (double b : { 10.0, 100.0, 1000.0 })
+        {
+                auto rk4 = IVP::delay(IVP::RungeKutta4(int(b*100.0)));
+                double t = seconds([&] () { rk4.solve(dde,0.0,1.0,b); });
+                IVP::History<double,double> history(1.0);
+                for (double s = 0.0; s<b; s += 0.01) history.push(s,0.01,0.0,0.0,0.0,0.0);
+                std::cout<<"\t [0,"<<std::fixed<<std::setprecision(0)<<b<<"]\t"<<std::setprecision(3)<<1.e6*t/(b*100.0)<<"us/step\t"
+                         <<history.size()<<" steps kept (capacity "<<history.capacity()<<")"<<std::endl;
+        }
+}
@@ -0,0 +1,100 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cmath>
+#include <chrono>
+
+#include "operators.h"
+#include <ivp.h>
+
+/* Jacobians of a nonlinear reaction-diffusion chain by dual numbers (several chunk widths) and by finite
+ * differences, against the analytic one. Then a stiff solve with backward Euler using fixed point iteration
+ * and Newton with both Jacobians.
+ */
+struct Chain
+{
+        double stiffness;
+        template<typename real, typename YType>
+        YType operator()(const real& t, const YType& y) const
+        {
+                using std::sin; using std::exp; using std::cos;
+                std::size_t n = y.size();
+                YType sol(n);
+                for (std::size_t i = 0; i<n; ++i)
+                        sol[i] = stiffness*(((i>0)?y[i-1]:y[i]) - 2.0*y[i] + ((i+1<n)?y[i+1]:y[i])) 
+                               - y[i]*y[i]*y[i] + sin(y[i])*exp(-0.1*y[(i+1)%n]) + cos(t);
+                return sol;
+        }
+
+        IVP::DenseMatrix<double> jacobian(double t, const std::vector<double>& y) const
+        {
+                std::size_t n = y.size();
+                IVP::DenseMatrix<double> sol(n,n);
+                for (std::size_t i = 0; i<n; ++i)
+                {
+                        sol(i,i) += -2.0*stiffness - 3.0*y[i]*y[i] + std::cos(y[i])*std::exp(-0.1*y[(i+1)%n]);
+                        sol(i,(i>0)?i-1:i) += stiffness;
+                        sol(i,(i+1<n)?i+1:i) += stiffness;
+                        sol(i,(i+1)%n) += -0.1*std::sin(y[i])*std::exp(-0.1*y[(i+1)%n]);
+                }
+                return sol;
+        }
+};
+
+template<typename F>
+double seconds_per_run(const F& f)
+{
+        f(); unsigned int n=0;
+        std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+        while (std::chrono::duration<double>(std::chrono::system_clock::now() - start).count()<=0.2)
+        {       f(); n++; }
+        return std::chrono::duration<double>(std::chrono::system_clock::now() - start).count()/double(n);
+}
+
+template<typename J>
+void bench_jacobian(const char* id, const J& jacobian, const Chain& f, const std::vector<double>& y)
+{
+        IVP::DenseMatrix<double> m;
+        double t = seconds_per_run([&] () { m = jacobian(f,0.5,y); });
+        IVP::DenseMatrix<double> exact = f.jacobian(0.5,y);
+        double error = 0.0;
+        for (std::size_t i = 0; i<y.size(); ++i) for (std::size_t j = 0; j<y.size(); ++j)
+                error = std::max(error,std::fabs(m(i,j) - exact(i,j))/std::max(1.0,std::fabs(exact(i,j))));
+        std::cout<<"\t "<<id<<std::fixed<<std::setprecision(2)<<std::setw(11)<<1.e6*t<<"us\t"<<std::scientific<<std::setprecision(2)<<error<<std::endl;
+}
+
+template<typename M>
+void bench_solve(const char* id, const M& m, const Chain& f, const std::vector<double>& y0, const std::vector<double>& reference)
+{
+        std::vector<double> y;
+        double t = seconds_per_run([&] () { y = m.solve(f,0.0,y0,1.0); });
+        double error = 0.0;
+        for (std::size_t i = 0; i<y.size(); ++i) if (!(std::fabs(y[i] - reference[i]) <= error)) error = std::fabs(y[i] - reference[i]); //NaN sticks
+        std::cout<<"\t "<<id<<std::fixed<<std::setprecision(2)<<std::setw(11)<<1.e3*t<<"ms\t"<<std::scientific<<std::setprecision(2)<<error<<std::endl;
+}
+
+int main(int argc, char** argv)
+{
+        for (std::size_t n : { 16, 64, 256 })
+        {
+                Chain f{100.0};
+                std::vector<double> y(n);
+                for (std::size_t i = 0; i<n; ++i) y[i] = std::sin(double(i));
+                std::cout<<"Jacobian, "<<n<<" elements (time / max relative error)"<<std::endl;
+                bench_jacobian("finite differences",IVP::FiniteDifferenceJacobian(),f,y);
+                bench_jacobian("dual, chunk 1     ",IVP::DualJacobian<1>(),f,y);
+                bench_jacobian("dual, chunk 4     ",IVP::DualJacobian<4>(),f,y);
+                bench_jacobian("dual, chunk 8     ",IVP::DualJacobian<8>(),f,y);
+                bench_jacobian("dual, chunk 16    ",IVP::DualJacobian<16>(),f,y);
+        }
+
+        const std::size_t n = 64;
+        Chain f{1000.0};
+        std::vector<double> y0(n);
+        for (std::size_t i = 0; i<n; ++i) y0[i] = std::sin(double(i));
+        std::vector<double> reference = IVP::BackwardEulerWith<IVP::NewtonIteration<>>(100000u,1.e-12).solve(f,0.0,y0,1.0);
+        std::cout<<"Backward Euler, 100 steps, "<<n<<" elements, stiffness 1000 (time / error against 10^5 steps)"<<std::endl;
+        bench_solve("fixed point       ",IVP::BackwardEuler(100u,1.e-8,IVP::FixedPointIteration(100)),f,y0,reference);
+        bench_solve("Newton, finite d. ",IVP::BackwardEulerWith<IVP::NewtonIteration<IVP::FiniteDifferenceJacobian>>(100u,1.e-8),f,y0,reference);
+        bench_solve("Newton, dual      ",IVP::BackwardEulerWith<IVP::NewtonIteration<>>(100u,1.e-8),f,y0,reference);
+}
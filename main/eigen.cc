@@ -0,0 +1,37 @@
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+
+#include <Eigen/Core>
+#include <ivp.h>
+#include <methods/eigen.h>
+
+/* Eigen vectors as YType (only built when Eigen is found): Adaptive<Dopri> on the harmonic oscillator with
+ * Eigen::VectorXd and Eigen::Vector2d, and a constant_linear_problem whose c1 is an Eigen::MatrixXd, stepped by
+ * RungeKutta4 with a precomputed propagator. Errors against cos(t), -sin(t) at t = 10.
+ */
+template<typename Vector>
+struct Oscillator
+{
+        template<typename real>
+        Vector operator()(const real& t, const Vector& y) const
+        {       Vector sol(2); sol << y(1), -y(0); return sol; }
+};
+
+template<typename Vector>
+double error(const Vector& y, double t)
+{       return std::max(std::fabs(y(0) - std::cos(t)),std::fabs(y(1) + std::sin(t))); }
+
+int main()
+{
+        const IVP::Adaptive<IVP::Dopri> dopri(1,1.e-10);
+        Eigen::VectorXd x(2); x << 1.0, 0.0;
+        Eigen::Vector2d x2(1.0,0.0);
+        std::cout<<std::scientific<<std::setprecision(2);
+        std::cout<<"Adaptive<Dopri>, VectorXd\t "<<error(dopri.solve(Oscillator<Eigen::VectorXd>(),0.0,x,10.0),10.0)<<std::endl;
+        std::cout<<"Adaptive<Dopri>, Vector2d\t "<<error(dopri.solve(Oscillator<Eigen::Vector2d>(),0.0,x2,10.0),10.0)<<std::endl;
+
+        Eigen::MatrixXd a(2,2); a << 0.0, 1.0, -1.0, 0.0;
+        Eigen::VectorXd zero = Eigen::VectorXd::Zero(2);
+        std::cout<<"RungeKutta4, MatrixXd c1\t "<<error(IVP::RungeKutta4(1000).solve(IVP::constant_linear_problem(a,zero),0.0,x,10.0),10.0)<<std::endl;
+}
@@ -0,0 +1,119 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cmath>
+#include <chrono>
+#include <atomic>
+
+#include "operators.h"
+#include <ivp.h>
+
+/* Gragg-Bulirsch-Stoer against Adaptive<Dopri>, work-precision:
+ *   - Arenstorf orbit over one period (the solution is periodic, so the reference is the initial state),
+ *   - 64 softened gravitating bodies over [0,1], an expensive f (O(n^2)), to see the speedup of computing the
+ *     extrapolation columns on 1, 2 and 4 threads.
+ */
+std::atomic<unsigned long> evaluations(0);
+
+struct Arenstorf
+{
+        template<typename real>
+        std::vector<double> operator()(const real& t, const std::vector<double>& y) const
+        {
+                ++evaluations;
+                const double mu = 0.012277471, nu = 1.0 - mu;
+                double d1 = std::pow((y[0] + mu)*(y[0] + mu) + y[1]*y[1],1.5);
+                double d2 = std::pow((y[0] - nu)*(y[0] - nu) + y[1]*y[1],1.5);
+                return std::vector<double>{ y[2], y[3],
+                        y[0] + 2.0*y[3] - nu*(y[0] + mu)/d1 - mu*(y[0] - nu)/d2,
+                        y[1] - 2.0*y[2] - nu*y[1]/d1 - mu*y[1]/d2 };
+        }
+};
+
+/* State (x_i, y_i, vx_i, vy_i) per body */
+struct Bodies
+{
+        template<typename real>
+        std::vector<double> operator()(const real& t, const std::vector<double>& y) const
+        {
+                ++evaluations;
+                std::size_t n = y.size()/4;
+                std::vector<double> sol(y.size(),0.0);
+                for (std::size_t i = 0; i<n; ++i)
+                {
+                        sol[4*i] = y[4*i+2]; sol[4*i+1] = y[4*i+3];
+                        for (std::size_t j = 0; j<n; ++j) if (j != i)
+                        {
+                                double dx = y[4*j] - y[4*i], dy = y[4*j+1] - y[4*i+1];
+                                double r2 = dx*dx + dy*dy + 0.01, inv = 1.0/(double(n)*r2*std::sqrt(r2));
+                                sol[4*i+2] += dx*inv; sol[4*i+3] += dy*inv;
+                        }
+                }
+                return sol;
+        }
+};
+
+template<typename F>
+double seconds(const F& f)
+{
+        std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+        f();
+        return std::chrono::duration<double>(std::chrono::system_clock::now() - start).count();
+}
+
+double distance(const std::vector<double>& a, const std::vector<double>& b)
+{
+        double sol = 0.0;
+        for (std::size_t i = 0; i<a.size(); ++i) sol = std::max(sol, std::fabs(a[i] - b[i]));
+        return sol;
+}
+
+template<typename M, typename F>
+double run(const char* id, const M& m, const F& f, const std::vector<double>& y_ini, double b, const std::vector<double>& reference)
+{
+        std::vector<double> y;
+        evaluations = 0;
+        double t = seconds([&] () { y = m.solve(f,0.0,y_ini,b); });
+        std::cout<<"\t "<<id<<"\t"<<std::scientific<<std::setprecision(2)<<distance(y,reference)<<"\t"
+                 <<std::setw(9)<<evaluations<<"\t"<<std::fixed<<std::setw(9)<<1.e3*t<<"ms"<<std::endl;
+        return t;
+}
+
+int main(int argc, char** argv)
+{
+        std::vector<double> arenstorf{ 0.994, 0.0, 0.0, -2.00158510637908252240537862224 };
+        const double period = 17.0652165601579625588917206249;
+
+        std::cout<<"Arenstorf orbit, one period\t\t error \t\t f evals \t time"<<std::endl;
+        for (double tol : { 1.e-6, 1.e-9, 1.e-12 })
+        {
+                std::cout<<"  tolerance "<<std::scientific<<std::setprecision(0)<<tol<<std::endl;
+                run("Dopri              ",IVP::Adaptive<IVP::Dopri>(100,tol),Arenstorf(),arenstorf,period,arenstorf);
+                run("Bulirsch-Stoer     ",IVP::BulirschStoer(100,tol),Arenstorf(),arenstorf,period,arenstorf);
+        }
+
+        const std::size_t n = 64;
+        const double pi = 3.14159265358979323846;
+        std::vector<double> bodies(4*n);
+        for (std::size_t i = 0; i<n; ++i)
+        {
+                double a = 2.0*pi*double(i)/double(n), r = 1.0 + 0.1*std::sin(3.0*a);
+                bodies[4*i] = r*std::cos(a); bodies[4*i+1] = r*std::sin(a);
+                bodies[4*i+2] = -0.8*std::sin(a); bodies[4*i+3] = 0.8*std::cos(a);
+        }
+        std::vector<double> reference = IVP::BulirschStoer(100,1.e-14).solve(Bodies(),0.0,bodies,1.0);
+
+        std::cout<<std::endl<<n<<" bodies, [0,1] ("<<std::thread::hardware_concurrency()<<" hardware threads)\t error \t\t f evals \t time"<<std::endl;
+        for (double tol : { 1.e-8, 1.e-12 })
+        {
+                std::cout<<"  tolerance "<<std::scientific<<std::setprecision(0)<<tol<<std::endl;
+                run("Dopri              ",IVP::Adaptive<IVP::Dopri>(100,tol),Bodies(),bodies,1.0,reference);
+                double serial = run("Bulirsch-Stoer     ",IVP::BulirschStoer(100,tol),Bodies(),bodies,1.0,reference);
+                for (std::size_t threads : { 2, 4 })
+                {
+                        double t = run(threads == 2 ? "B-S, 2 threads     " : "B-S, 4 threads     ",
+                                       IVP::BulirschStoer(100,tol,8,IVP::thread_pool(threads)),Bodies(),bodies,1.0,reference);
+                        std::cout<<"\t\t speedup "<<std::fixed<<std::setprecision(2)<<serial/t<<std::endl;
+                }
+        }
+}
@@ -0,0 +1,50 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+
+#include "operators.h"
+#include <ivp.h>
+
+template<typename F>
+double seconds_per_run(const F& f)
+{
+        f(); unsigned int n=0;
+        std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+        while (std::chrono::duration<double>(std::chrono::system_clock::now() - start).count()<=0.2)
+        {       f(); n++; }
+        return std::chrono::duration<double>(std::chrono::system_clock::now() - start).count()/double(n);
+}
+
+template<typename T>
+void bench(const char* id, std::size_t n)
+{
+        std::vector<T> y(n,T(1)), k0(n,T(0.5)), k2(n,T(0.25)), k3(n,T(0.125)), k4(n,T(2)), k5(n,T(3)), k6(n,T(4)), out(n);
+
+        double copy = seconds_per_run([&] () { std::copy(y.begin(),y.end(),out.begin()); });
+        double chained = seconds_per_run([&] () {
+                out = y + (5179.0/57600.0)*k0 + (7571.0/16695.0)*k2 + (393.0/640.0)*k3 + (-92097.0/339200.0)*k4
+                        + (187.0/2100.0)*k5 + (1.0/40.0)*k6; });
+        double fused = seconds_per_run([&] () {
+                out = IVP::linear_combination(y,
+                        {5179.0/57600.0, 7571.0/16695.0, 393.0/640.0, -92097.0/339200.0, 187.0/2100.0, 1.0/40.0}, k0, k2, k3, k4, k5, k6); });
+
+        //Minimum traffic: read y and the six stages, write the result
+        double bytes = 8.0*double(n*sizeof(T));
+        double peak = 2.0*double(n*sizeof(T))/copy;
+        std::cout<<id<<std::endl;
+        std::cout<<"\t copy    "<<std::fixed<<std::setw(9)<<std::setprecision(2)<<1.e6*copy<<"us\t"
+                 <<std::setw(7)<<1.e-9*peak<<"GB/s"<<std::endl;
+        std::cout<<"\t chained "<<std::setw(9)<<1.e6*chained<<"us\t"<<std::setw(7)<<1.e-9*bytes/chained<<"GB/s\t"
+                 <<std::setw(6)<<100.0*bytes/chained/peak<<"%"<<std::endl;
+        std::cout<<"\t fused   "<<std::setw(9)<<1.e6*fused<<"us\t"<<std::setw(7)<<1.e-9*bytes/fused<<"GB/s\t"
+                 <<std::setw(6)<<100.0*bytes/fused/peak<<"%"<<std::endl<<std::endl;
+}
+
+int main(int argc, char** argv)
+{
+        std::cout<<"Kernel: "<<IVP::fused::isa_name(IVP::fused::isa())<<std::endl<<std::endl;
+        bench<double>("y + 6 stages, 10^6 doubles",1000000);
+        bench<float>("y + 6 stages, 10^6 floats",1000000);
+}
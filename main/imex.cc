@@ -0,0 +1,86 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cmath>
+#include <chrono>
+
+#include "operators.h"
+#include <ivp.h>
+
+/* Allen-Cahn equation y_t = D*y_xx + y - y^3 on 100 interior points with y = 0 at both ends, over [0,2].
+ * Diffusion is the stiff linear part (|eigenvalues| up to 4*D/dx^2 ~ 2*10^4) and the reaction the non stiff
+ * nonlinear one. IMEX methods under Adaptive against the explicit Dopri (steps limited by stability) and the
+ * fully implicit backward Euler with Newton (a finite difference Jacobian and a factorization per step).
+ */
+unsigned long evaluations = 0;
+
+struct Reaction
+{
+        template<typename real, typename YType>
+        YType operator()(const real& t, const YType& y) const
+        {
+                ++evaluations;
+                YType sol = y;
+                for (std::size_t i = 0; i<y.size(); ++i) sol[i] = y[i] - y[i]*y[i]*y[i];
+                return sol;
+        }
+};
+
+template<typename F>
+double seconds(const F& f)
+{
+        std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+        f();
+        return std::chrono::duration<double>(std::chrono::system_clock::now() - start).count();
+}
+
+double distance(const std::vector<double>& a, const std::vector<double>& b)
+{
+        double sol = 0.0;
+        for (std::size_t i = 0; i<a.size(); ++i) sol = std::max(sol, std::fabs(a[i] - b[i]));
+        return sol;
+}
+
+template<typename M, typename F>
+void run(const char* id, const M& m, const F& f, const std::vector<double>& y_ini, double b, const std::vector<double>& reference)
+{
+        std::vector<double> y; std::size_t steps = 0;
+        evaluations = 0;
+        double t = seconds([&] () { for (const auto& s : m.steps(f,0.0,y_ini,b)) { y = s.y(); ++steps; } });
+        std::cout<<"\t "<<id<<"\t"<<std::scientific<<std::setprecision(2)<<distance(y,reference)<<"\t"
+                 <<std::setw(7)<<steps<<"\t"<<std::setw(9)<<evaluations<<"\t"<<std::fixed<<std::setw(9)<<1.e3*t<<"ms"<<std::endl;
+}
+
+int main(int argc, char** argv)
+{
+        const std::size_t n = 100;
+        const double pi = 3.14159265358979323846, d = 0.5, dx = 1.0/double(n + 1);
+        IVP::DenseMatrix<double> laplacian(n,n);
+        for (std::size_t i = 0; i<n; ++i)
+        {
+                laplacian(i,i) = -2.0*d/(dx*dx);
+                if (i>0)   laplacian(i,i-1) = d/(dx*dx);
+                if (i+1<n) laplacian(i,i+1) = d/(dx*dx);
+        }
+        std::vector<double> y_ini(n);
+        for (std::size_t i = 0; i<n; ++i) y_ini[i] = 0.5*std::sin(pi*double(i + 1)*dx) + 0.3*std::sin(5.0*pi*double(i + 1)*dx);
+
+        auto f = IVP::additive_problem([&laplacian] (double t) -> const IVP::DenseMatrix<double>& { return laplacian; },
+                                       [n] (double t) { return std::vector<double>(n,0.0); }, Reaction());
+        std::vector<double> reference = IVP::Adaptive<IVP::ARK436L2SA>(100,1.e-12).solve(f,0.0,y_ini,2.0);
+
+        std::cout<<"Allen-Cahn, "<<n<<" points, [0,2]\t\t error \t\t steps \t f evals \t time"<<std::endl;
+        for (double tol : { 1.e-3, 1.e-5, 1.e-7 })
+        {
+                std::cout<<"  tolerance "<<std::scientific<<std::setprecision(0)<<tol<<std::endl;
+                run("Dopri (explicit)     ",IVP::Adaptive<IVP::Dopri>(100,tol),f,y_ini,2.0,reference);
+                run("ARK3(2)4L (IMEX)     ",IVP::Adaptive<IVP::ARK324L2SA>(100,tol),f,y_ini,2.0,reference);
+                run("ARK4(3)6L (IMEX)     ",IVP::Adaptive<IVP::ARK436L2SA>(100,tol),f,y_ini,2.0,reference);
+        }
+        std::cout<<"  fixed steps"<<std::endl;
+        for (unsigned int steps : { 50u, 200u })
+        {
+                run("Backward Euler+Newton",IVP::BackwardEulerWith<IVP::NewtonIteration<IVP::FiniteDifferenceJacobian>>(steps,1.e-10),f,y_ini,2.0,reference);
+                run("ARK4(3)6L (IMEX)     ",IVP::ARK436L2SA(steps),f,y_ini,2.0,reference);
+        }
+}
@@ -0,0 +1,149 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cmath>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+
+#include "operators.h"
+#include <ivp.h>
+
+/* Method of lines for the 2D reaction-diffusion u_t = u_xx + u_yy + u^2*(1 - u) on the unit square, u = 0 on the
+ * border, on N x N interior points, from a bump. Backward Euler with 10 steps over [0,0.01], which is stiff
+ * (h*|lambda| up to about 8*10^-3*N^2), solved by:
+ *   - Newton with a dense Jacobian (dual numbers) and LU, only while it fits in time (n^2 memory, n^3 time)
+ *   - Newton-Krylov (GMRES(30)), matrix free, with no preconditioner, with the diagonal of df/dy (which here is
+ *     about constant, so it does little) and with two symmetric Gauss-Seidel sweeps on the diffusion
+ * Time, evaluations of f, memory of the linear algebra and difference with the dense solution. N doubles from 16
+ * up to the first argument (256 by default).
+ */
+std::size_t evaluations = 0;
+
+struct ReactionDiffusion
+{
+        std::size_t N;
+        template<typename real, typename YType>
+        YType operator()(const real& t, const YType& u) const
+        {
+                ++evaluations;
+                const double h2 = double(N + 1)*double(N + 1);
+                YType sol(u.size());
+                for (std::size_t i = 0; i<N; ++i) for (std::size_t j = 0; j<N; ++j)
+                {
+                        std::size_t k = i*N + j;
+                        auto laplacian = -4.0*u[k];
+                        if (i > 0)     laplacian += u[k - N];
+                        if (i + 1 < N) laplacian += u[k + N];
+                        if (j > 0)     laplacian += u[k - 1];
+                        if (j + 1 < N) laplacian += u[k + 1];
+                        sol[k] = h2*laplacian + u[k]*u[k]*(1.0 - u[k]);
+                }
+                return sol;
+        }
+};
+
+/* Diagonal of df/du */
+struct ReactionDiffusionDiagonal
+{
+        std::size_t N;
+        std::vector<double> operator()(double t, const std::vector<double>& u) const
+        {
+                std::vector<double> sol(u.size());
+                for (std::size_t k = 0; k<u.size(); ++k) sol[k] = -4.0*double(N + 1)*double(N + 1) + 2.0*u[k] - 3.0*u[k]*u[k];
+                return sol;
+        }
+};
+
+/* A preconditioner of our own: symmetric Gauss-Seidel sweeps on I - a*(diffusion part of df/du), which is what
+ * makes the problem stiff. A fixed number of sweeps is a fixed linear operator, as GMRES needs.
+ */
+struct DiffusionSGS
+{
+        std::size_t N; unsigned int sweeps;
+
+        struct Apply
+        {
+                std::size_t N; unsigned int sweeps; double off, diagonal;
+
+                void sweep(std::vector<double>& z, const std::vector<double>& v, std::size_t i, std::size_t j) const
+                {
+                        std::size_t k = i*N + j;
+                        double s = v[k];
+                        if (i > 0)     s -= off*z[k - N];
+                        if (i + 1 < N) s -= off*z[k + N];
+                        if (j > 0)     s -= off*z[k - 1];
+                        if (j + 1 < N) s -= off*z[k + 1];
+                        z[k] = s/diagonal;
+                }
+
+                void operator()(std::vector<double>& v) const
+                {
+                        std::vector<double> z(v.size(),0.0);
+                        for (unsigned int s = 0; s<sweeps; ++s)
+                        {
+                                for (std::size_t i = 0; i<N; ++i) for (std::size_t j = 0; j<N; ++j) sweep(z,v,i,j);
+                                for (std::size_t i = N; i-->0; ) for (std::size_t j = N; j-->0; ) sweep(z,v,i,j);
+                        }
+                        v.swap(z);
+                }
+        };
+
+        template<typename Function>
+        Apply prepare(const Function& f, double t, const std::vector<double>& u, double a) const
+        {
+                double h2 = double(N + 1)*double(N + 1);
+                return Apply{ N, sweeps, -a*h2, 1.0 + 4.0*a*h2 };
+        }
+};
+
+template<typename M>
+std::vector<double> run(const char* id, const M& m, std::size_t N, double megabytes, const std::vector<double>& reference)
+{
+        std::vector<double> u0(N*N);
+        for (std::size_t i = 0; i<N; ++i) for (std::size_t j = 0; j<N; ++j)
+        {
+                double x = double(i + 1)/double(N + 1) - 0.5, y = double(j + 1)/double(N + 1) - 0.5;
+                u0[i*N + j] = std::exp(-50.0*(x*x + y*y));
+        }
+        evaluations = 0;
+        std::vector<double> u;
+        auto start = std::chrono::steady_clock::now();
+        u = m.solve(ReactionDiffusion{N},0.0,u0,0.01);
+        double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout<<"\t "<<std::left<<std::setw(24)<<id<<std::right<<std::fixed<<std::setprecision(1)<<std::setw(10)<<1.e3*t<<" ms"
+                 <<std::setw(10)<<evaluations<<std::setw(10)<<megabytes<<" MB\t";
+        if (reference.empty()) std::cout<<"  -";
+        else
+        {
+                double d = 0.0;
+                for (std::size_t k = 0; k<u.size(); ++k) d = std::max(d,std::fabs(u[k] - reference[k]));
+                std::cout<<std::scientific<<std::setprecision(2)<<d;
+        }
+        std::cout<<std::endl;
+        return u;
+}
+
+int main(int argc, char** argv)
+{
+        const double tolerance = 1.e-8;
+        const unsigned int restart = 30;
+        const std::size_t largest = (argc > 1)?std::size_t(std::atoi(argv[1])):std::size_t(256);
+        for (std::size_t N = 16; N<=largest; N*=2)
+        {
+                const std::size_t n = N*N;
+                std::cout<<"N = "<<N<<", "<<n<<" unknowns\t\t time\t  evaluations\t memory\t  |u - u(dense)|"<<std::endl;
+                std::vector<double> dense;
+                if (N <= 32)
+                        dense = run("Newton, dense",IVP::BackwardEulerWith<IVP::NewtonIteration<>>(10u,tolerance),N,
+                                    8.0*double(n)*double(n)*2.0/1.e6,std::vector<double>());
+                const double krylov = 8.0*double(n)*double(restart + 8)/1.e6;
+                run("Newton-Krylov",IVP::BackwardEulerWith<IVP::NewtonKrylovIteration<>>(10u,tolerance,
+                    IVP::NewtonKrylovIteration<>(20,restart)),N,krylov,dense);
+                using Diagonal = IVP::DiagonalPreconditioner<ReactionDiffusionDiagonal>;
+                run("Newton-Krylov, diagonal",IVP::BackwardEulerWith<IVP::NewtonKrylovIteration<Diagonal>>(10u,tolerance,
+                    IVP::NewtonKrylovIteration<Diagonal>(20,restart,1.e-3,10,Diagonal(ReactionDiffusionDiagonal{N}))),N,krylov,dense);
+                run("Newton-Krylov, SGS",IVP::BackwardEulerWith<IVP::NewtonKrylovIteration<DiffusionSGS>>(10u,tolerance,
+                    IVP::NewtonKrylovIteration<DiffusionSGS>(20,restart,1.e-3,10,DiffusionSGS{N,2})),N,krylov,dense);
+        }
+}
@@ -0,0 +1,77 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cmath>
+#include <chrono>
+#include <algorithm>
+
+#include "operators.h"
+#include <ivp.h>
+
+/* Constant coefficient linear problems y' = c1*y + c0, as a plain function and as a constant_linear_problem
+ * (whose steps are a single precomputed propagator, R(h*c1) applied to y):
+ *   - y' = -2*y + 1 with a scalar c1, many short solves.
+ *   - The heat equation u_t = u_xx on (0,1) with u(0,t) = 1, u(1,t) = 0, on n points, with a DenseMatrix c1:
+ *     RungeKutta4 with fixed steps (the propagator is computed once, in O(n^3)) and Adaptive<Dopri> (it is
+ *     computed again whenever the step changes).
+ * Time per solve and difference between both solutions.
+ */
+template<typename F>
+double seconds_per_run(const F& f)
+{
+        f(); unsigned int n=0;
+        auto start = std::chrono::steady_clock::now();
+        while (std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()<=0.2)
+        {       f(); n++; }
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()/double(n);
+}
+
+double difference(double a, double b) { return std::fabs(a - b); }
+double difference(const std::vector<double>& a, const std::vector<double>& b)
+{
+        double d = 0.0;
+        for (std::size_t i = 0; i<a.size(); ++i) d = std::max(d,std::fabs(a[i] - b[i]));
+        return d;
+}
+
+template<typename M, typename F, typename P, typename YType>
+void compare(const char* id, const M& m, const F& f, const P& p, const YType& y0, double t_end)
+{
+        YType y_f, y_p;
+        double t_f = seconds_per_run([&] () { y_f = m.solve(f,0.0,y0,t_end); });
+        double t_p = seconds_per_run([&] () { y_p = m.solve(p,0.0,y0,t_end); });
+        std::cout<<"\t "<<std::left<<std::setw(28)<<id<<std::right<<std::fixed<<std::setprecision(2)
+                 <<std::setw(10)<<1.e6*t_f<<" us"<<std::setw(10)<<1.e6*t_p<<" us"<<std::setw(8)<<t_f/t_p<<"x\t"
+                 <<std::scientific<<std::setprecision(2)<<difference(y_f,y_p)<<std::endl;
+}
+
+int main()
+{
+        std::cout<<"\t\t\t\t\t function\t propagator\t speedup\t difference"<<std::endl;
+        std::cout<<"y' = -2*y + 1"<<std::endl;
+        compare("RungeKutta4, 100 steps",IVP::RungeKutta4(100),[] (double t, double y) { return -2.0*y + 1.0; },
+                IVP::constant_linear_problem(-2.0,1.0),0.0,1.0);
+        compare("Adaptive<Dopri>, tol 1e-8",IVP::Adaptive<IVP::Dopri>(1,1.e-8),[] (double t, double y) { return -2.0*y + 1.0; },
+                IVP::constant_linear_problem(-2.0,1.0),0.0,1.0);
+
+        for (std::size_t n : { 16, 64 })
+        {
+                const double dx2 = double(n + 1)*double(n + 1);
+                IVP::DenseMatrix<double> a(n,n);
+                for (std::size_t i = 0; i<n; ++i)
+                {
+                        a(i,i) = -2.0*dx2;
+                        if (i > 0)     a(i,i - 1) = dx2;
+                        if (i + 1 < n) a(i,i + 1) = dx2;
+                }
+                std::vector<double> c0(n,0.0); c0[0] = dx2;
+                auto f = [&] (double t, const std::vector<double>& y) { return a*y + c0; };
+                auto p = IVP::constant_linear_problem(a,c0);
+                const std::vector<double> y0(n,0.0);
+                //Explicit methods are stable for h*4*dx2 below about 2.8
+                const unsigned int steps = (unsigned int)(std::ceil(0.1*4.0*dx2/2.5));
+                std::cout<<"Heat equation, "<<n<<" points, t in [0,0.1]"<<std::endl;
+                compare("RungeKutta4, fixed steps",IVP::RungeKutta4(steps),f,p,y0,0.1);
+                compare("Adaptive<Dopri>, tol 1e-6",IVP::Adaptive<IVP::Dopri>(steps,1.e-6),f,p,y0,0.1);
+        }
+}
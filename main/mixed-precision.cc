@@ -0,0 +1,76 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cmath>
+#include <chrono>
+#include <type_traits>
+
+#include "operators.h"
+#include <ivp.h>
+
+/* Work-precision of all-double, all-float and mixed precision (float stages, double accumulation) on
+ * y_i' = -l_i (y_i - cos(t)), y_i(0) = 1, with n = 10^6 independent rates l_i in [0.5,2] (so that the
+ * state does not fit in cache).
+ */
+const std::size_t n = 1000000;
+std::vector<double> rates_d;
+std::vector<float>  rates_f;
+
+template<typename T>
+const std::vector<T>& rates() { if constexpr (std::is_same<T,float>::value) return rates_f; else return rates_d; }
+
+struct Problem
+{
+        template<typename real, typename YType>
+        YType operator()(const real& t, const YType& y) const
+        {
+                using T = typename YType::value_type;
+                const std::vector<T>& l = rates<T>();
+                T c = T(std::cos(t));
+                YType sol(y.size());
+                for (std::size_t i = 0; i<y.size(); ++i) sol[i] = -l[i]*(y[i] - c);
+                return sol;
+        }
+};
+
+double exact(double l, double t)
+{       return std::exp(-l*t)/(l*l + 1.0) + l*(l*std::cos(t) + std::sin(t))/(l*l + 1.0); }
+
+template<typename YType>
+double error(const YType& y, double t)
+{
+        double sol = 0.0;
+        for (std::size_t i = 0; i<y.size(); ++i) sol = std::max(sol, std::fabs(double(y[i]) - exact(rates_d[i],t)));
+        return sol;
+}
+
+template<typename F>
+double seconds(const F& f)
+{
+        std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+        f();
+        return std::chrono::duration<double>(std::chrono::system_clock::now() - start).count();
+}
+
+int main(int argc, char** argv)
+{
+        for (std::size_t i = 0; i<n; ++i) rates_d.push_back(0.5 + 1.5*double(i)/double(n));
+        rates_f = std::vector<float>(rates_d.begin(),rates_d.end());
+        const double b = 10.0;
+
+        std::cout<<"Dopri (fixed steps), y_i' = -l_i (y_i - cos(t)), 10^6 elements, [0,10]"<<std::endl;
+        std::cout<<" steps \t  double (error / time) \t   float (error / time) \t   mixed (error / time)"<<std::endl;
+        for (int steps : { 10, 20, 50, 100, 200 })
+        {
+                IVP::Dopri dopri(steps);
+                auto mixed = IVP::mixed_precision(dopri);
+                std::vector<double> yd; std::vector<float> yf; std::vector<double> ym;
+                double td = seconds([&] () { yd = dopri.solve(Problem(), 0.0, std::vector<double>(n,1.0), b); });
+                double tf = seconds([&] () { yf = dopri.solve(Problem(), 0.0f, std::vector<float>(n,1.0f), float(b)); });
+                double tm = seconds([&] () { ym = mixed.solve(Problem(), 0.0, std::vector<double>(n,1.0), b); });
+                std::cout<<std::setw(6)<<steps<<"\t"<<std::scientific<<std::setprecision(2)
+                         <<error(yd,b)<<" "<<std::fixed<<std::setw(9)<<1.e3*td<<"ms\t"<<std::scientific
+                         <<error(yf,b)<<" "<<std::fixed<<std::setw(9)<<1.e3*tf<<"ms\t"<<std::scientific
+                         <<error(ym,b)<<" "<<std::fixed<<std::setw(9)<<1.e3*tm<<"ms"<<std::endl;
+        }
+}
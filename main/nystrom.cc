@@ -0,0 +1,105 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cmath>
+#include <chrono>
+
+#include "operators.h"
+#include <ivp.h>
+
+/* Second order problems integrated natively (Runge-Kutta-Nystrom) and through the first order reformulation:
+ * Kepler orbit with eccentricity 0.6 over one period, and a chain of 10^4 nonlinear springs.
+ */
+unsigned long evaluations = 0;
+
+struct Kepler
+{
+        template<typename real>
+        std::vector<double> operator()(const real& t, const std::vector<double>& y) const
+        {
+                ++evaluations;
+                double r = std::sqrt(y[0]*y[0] + y[1]*y[1]);
+                double r3 = r*r*r;
+                return std::vector<double>{ -y[0]/r3, -y[1]/r3 };
+        }
+};
+
+struct Springs
+{
+        template<typename real>
+        std::vector<double> operator()(const real& t, const std::vector<double>& y) const
+        {
+                ++evaluations;
+                std::size_t n = y.size();
+                std::vector<double> sol(n);
+                for (std::size_t i = 0; i<n; ++i)
+                {
+                        double l = y[i] - ((i>0)?y[i-1]:0.0), r = ((i+1<n)?y[i+1]:0.0) - y[i];
+                        sol[i] = r - l + 0.25*(r*r*r - l*l*l);
+                }
+                return sol;
+        }
+};
+
+template<typename F>
+double seconds(const F& f)
+{
+        std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+        f();
+        return std::chrono::duration<double>(std::chrono::system_clock::now() - start).count();
+}
+
+double distance(const IVP::SecondOrderState<std::vector<double>>& a, const IVP::SecondOrderState<std::vector<double>>& b)
+{
+        double sol = 0.0;
+        for (std::size_t i = 0; i<a.y.size(); ++i) sol = std::max({ sol, std::fabs(a.y[i] - b.y[i]), std::fabs(a.v[i] - b.v[i]) });
+        return sol;
+}
+
+template<typename M, typename F>
+void run(const char* id, const M& m, const F& f, const IVP::SecondOrderState<std::vector<double>>& x0, double b,
+        const IVP::SecondOrderState<std::vector<double>>& reference)
+{
+        IVP::SecondOrderState<std::vector<double>> x;
+        evaluations = 0;
+        double t = seconds([&] () { x = m.solve(f,0.0,x0,b); });
+        std::cout<<"\t "<<id<<"\t"<<std::scientific<<std::setprecision(2)<<distance(x,reference)<<"\t"
+                 <<std::setw(9)<<evaluations<<"\t"<<std::fixed<<std::setw(9)<<1.e3*t<<"ms"<<std::endl;
+}
+
+int main(int argc, char** argv)
+{
+        const double pi = 3.14159265358979323846, e = 0.6;
+        auto kepler = IVP::second_order_state(std::vector<double>{ 1.0 - e, 0.0 }, std::vector<double>{ 0.0, std::sqrt((1.0 + e)/(1.0 - e)) });
+
+        std::cout<<"Kepler, e = 0.6, one period\t\t error \t\t f evals \t time"<<std::endl;
+        for (int steps : { 200, 1000 })
+        {
+                std::cout<<"  "<<steps<<" steps"<<std::endl;
+                run("RK2 (first order)  ",IVP::RungeKutta2(steps),IVP::first_order(Kepler()),kepler,2.0*pi,kepler);
+                run("Stormer-Verlet     ",IVP::StormerVerlet(steps),Kepler(),kepler,2.0*pi,kepler);
+                run("RK4 (first order)  ",IVP::RungeKutta4(steps),IVP::first_order(Kepler()),kepler,2.0*pi,kepler);
+                run("Nystrom 4          ",IVP::RungeKuttaNystrom4(steps),Kepler(),kepler,2.0*pi,kepler);
+        }
+        for (double tol : { 1.e-4, 1.e-6, 1.e-8 })
+        {
+                std::cout<<"  tolerance "<<std::scientific<<std::setprecision(0)<<tol<<std::endl;
+                run("Dopri (first order)",IVP::Adaptive<IVP::Dopri>(100,tol),IVP::first_order(Kepler()),kepler,2.0*pi,kepler);
+                run("Nystrom 4(3)       ",IVP::Adaptive<IVP::RungeKuttaNystrom43>(100,tol),Kepler(),kepler,2.0*pi,kepler);
+        }
+
+        const std::size_t n = 10000;
+        std::vector<double> y0(n), v0(n,0.0);
+        for (std::size_t i = 0; i<n; ++i) y0[i] = 0.1*std::sin(pi*double(i)/double(n - 1));
+        auto springs = IVP::second_order_state(y0,v0);
+        auto reference = IVP::RungeKuttaNystrom4(20000).solve(Springs(),0.0,springs,10.0);
+        std::cout<<std::endl<<"Springs, 10^4 elements, [0,10]\t\t error \t\t f evals \t time"<<std::endl;
+        for (int steps : { 50, 200 })
+        {
+                std::cout<<"  "<<steps<<" steps"<<std::endl;
+                run("RK2 (first order)  ",IVP::RungeKutta2(steps),IVP::first_order(Springs()),springs,10.0,reference);
+                run("Stormer-Verlet     ",IVP::StormerVerlet(steps),Springs(),springs,10.0,reference);
+                run("RK4 (first order)  ",IVP::RungeKutta4(steps),IVP::first_order(Springs()),springs,10.0,reference);
+                run("Nystrom 4          ",IVP::RungeKuttaNystrom4(steps),Springs(),springs,10.0,reference);
+        }
+}
@@ -0,0 +1,7 @@
+#ifndef _IVP_MAIN_OPERATORS_H_
+#define _IVP_MAIN_OPERATORS_H_
+
+/* Elementwise operators for std::vector as YType, as used by the examples. They must be included before ivp.h */
+#include "../methods/vector-operators.h"
+
+#endif
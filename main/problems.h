@@ -0,0 +1,139 @@
+#ifndef _IVP_MAIN_PROBLEMS_H_
+#define _IVP_MAIN_PROBLEMS_H_
+
+#include <vector>
+#include <string>
+#include <functional>
+#include <cmath>
+
+/* Standard benchmark problems (see Hairer, Norsett & Wanner, Solving ODEs I and II, and the IVP test set of
+ * Mazzia & Magherini), with their solution at the end of the interval:
+ *   - lorenz       chaotic, non stiff (sigma = 10, rho = 28, beta = 8/3)
+ *   - pleiades     7 bodies in the plane, non stiff
+ *   - brusselator  1D reaction-diffusion, 32 points (64 equations), mildly stiff
+ *   - hires        8 chemical reactions, stiff
+ *   - van-der-pol  mu = 1000, very stiff (only the start of the slow phase, so that explicit methods finish)
+ *   - robertson    3 chemical reactions, very stiff (up to t = 40)
+ * The references of hires (from the test set) and robertson (from Hairer & Wanner) are published ones. The rest
+ * were computed with BulirschStoer at tolerance 1e-14 (work-precision --reference computes them again), and agree
+ * with Adaptive<Dopri> at the same tolerance to about 1e-10 (pleiades, van-der-pol) or 1e-12 (lorenz,
+ * brusselator): smaller errors are not meaningful.
+ *
+ * Functions are std::function, as they are meant to be used with AnySolver (i.e. from the ivp-any-solver library).
+ */
+struct TestProblem
+{
+        std::string name;
+        bool stiff;
+        std::function<std::vector<double>(double, const std::vector<double>&)> f;
+        double t_ini, t_end;
+        std::vector<double> y_ini, reference;
+};
+
+inline std::vector<double> lorenz(double t, const std::vector<double>& y)
+{       return std::vector<double>{ 10.0*(y[1] - y[0]), y[0]*(28.0 - y[2]) - y[1], y[0]*y[1] - (8.0/3.0)*y[2] }; }
+
+/* State (x_1..x_7, y_1..y_7, x_1'..x_7', y_1'..y_7'), masses m_i = i */
+inline std::vector<double> pleiades(double t, const std::vector<double>& y)
+{
+        std::vector<double> sol(28,0.0);
+        for (int i = 0; i<7; ++i) { sol[i] = y[14 + i]; sol[7 + i] = y[21 + i]; }
+        for (int i = 0; i<7; ++i)
+                for (int j = 0; j<7; ++j) if (i != j)
+                {
+                        double dx = y[j] - y[i], dy = y[7 + j] - y[7 + i];
+                        double r3 = std::pow(dx*dx + dy*dy,1.5);
+                        sol[14 + i] += double(j + 1)*dx/r3;
+                        sol[21 + i] += double(j + 1)*dy/r3;
+                }
+        return sol;
+}
+
+/* State (u_1, v_1, u_2, v_2, ...), with u = 1 and v = 3 at both boundaries, alpha = 1/50 */
+inline std::vector<double> brusselator(double t, const std::vector<double>& y)
+{
+        const std::size_t n = y.size()/2;
+        const double c = (1.0/50.0)*double(n + 1)*double(n + 1);
+        std::vector<double> sol(y.size());
+        for (std::size_t i = 0; i<n; ++i)
+        {
+                double u = y[2*i], v = y[2*i + 1];
+                double u_l = (i>0)?y[2*i - 2]:1.0, v_l = (i>0)?y[2*i - 1]:3.0;
+                double u_r = (i+1<n)?y[2*i + 2]:1.0, v_r = (i+1<n)?y[2*i + 3]:3.0;
+                sol[2*i]     = 1.0 + u*u*v - 4.0*u + c*(u_l - 2.0*u + u_r);
+                sol[2*i + 1] = 3.0*u - u*u*v + c*(v_l - 2.0*v + v_r);
+        }
+        return sol;
+}
+
+inline std::vector<double> hires(double t, const std::vector<double>& y)
+{
+        return std::vector<double>{
+                -1.71*y[0] + 0.43*y[1] + 8.32*y[2] + 0.0007,
+                1.71*y[0] - 8.75*y[1],
+                -10.03*y[2] + 0.43*y[3] + 0.035*y[4],
+                8.32*y[1] + 1.71*y[2] - 1.12*y[3],
+                -1.745*y[4] + 0.43*y[5] + 0.43*y[6],
+                -280.0*y[5]*y[7] + 0.69*y[3] + 1.71*y[4] - 0.43*y[5] + 0.69*y[6],
+                280.0*y[5]*y[7] - 1.81*y[6],
+                -280.0*y[5]*y[7] + 1.81*y[6] };
+}
+
+inline std::vector<double> van_der_pol(double t, const std::vector<double>& y)
+{       return std::vector<double>{ y[1], 1000.0*(1.0 - y[0]*y[0])*y[1] - y[0] }; }
+
+inline std::vector<double> robertson(double t, const std::vector<double>& y)
+{
+        return std::vector<double>{ -0.04*y[0] + 1.e4*y[1]*y[2],
+                0.04*y[0] - 1.e4*y[1]*y[2] - 3.e7*y[1]*y[1],
+                3.e7*y[1]*y[1] };
+}
+
+inline std::vector<double> brusselator_initial(std::size_t n)
+{
+        const double pi = 3.14159265358979323846;
+        std::vector<double> y(2*n);
+        for (std::size_t i = 0; i<n; ++i) { y[2*i] = 1.0 + std::sin(2.0*pi*double(i + 1)/double(n + 1)); y[2*i + 1] = 3.0; }
+        return y;
+}
+
+inline const std::vector<TestProblem>& test_problems()
+{
+        static const std::vector<TestProblem> problems{
+                { "lorenz", false, lorenz, 0.0, 10.0, { 1.0, 0.0, 0.0 }, { -5.8576853824250206, -5.8310824864285875, 23.932132987025859 } },
+                { "pleiades", false, pleiades, 0.0, 3.0,
+                  { 3.0, 3.0, -1.0, -3.0, 2.0, -2.0, 2.0,   3.0, -3.0, 2.0, 0.0, 0.0, -4.0, 4.0,
+                    0.0, 0.0, 0.0, 0.0, 0.0, 1.75, -1.5,    0.0, 0.0, 0.0, -1.25, 1.0, 0.0, 0.0 }, {
+                    0.37061391418926942, 3.2372840920570667, -3.2225590324120552, 0.65970914558319016,
+                    0.34255817072036737, 1.5621721014065482, -0.70030929220570348, -3.9434375857180641,
+                    -3.2713809739744302, 5.2250818434181996, -2.5906124349854474, 1.1982136934266703,
+                    -0.24296823449527261, 1.0914492404551299, 3.4170038057875747, 1.3545845016297922,
+                    -2.5900655977965403, 2.0250537348043633, -1.15581510020289, -0.80729881700241191,
+                    0.59523963545080982, -3.7412449615558439, 0.37734596857113456, 0.9386858869178043,
+                    0.3667922227317868, -0.34740463535522792, 2.3449154481794627, -1.9470204342243103 } },
+                { "brusselator", false, brusselator, 0.0, 10.0, brusselator_initial(32), {
+                    0.92171999756340584, 3.0988158709846387, 0.84631393280603429, 3.1938982018775799,
+                    0.77608845843203678, 3.2821827586722785, 0.7126245833455418, 3.3615077890739857,
+                    0.65676461735912717, 3.4306678723533883, 0.60871036135161483, 3.4893233402152539,
+                    0.56818133810909832, 3.5378227443531847, 0.53458550755069367, 3.5769947503275437,
+                    0.50717026276145316, 3.6079505350920553, 0.48513865756706764, 3.6319190700432333,
+                    0.46772886042501005, 3.6501224351908563, 0.45426221098943093, 3.6636887721865157,
+                    0.44416799865084167, 3.6735959936427185, 0.43699297631980211, 3.6806382579269803,
+                    0.43240220526991735, 3.6854079291501156, 0.43017607514756384, 3.6882872010333672,
+                    0.43020673585166719, 3.6894451831909429, 0.43249586336960621, 3.6888377808749793,
+                    0.43715462764884144, 3.6862090936769834, 0.44440582164614612, 3.6810943625268746,
+                    0.454587201822788, 3.6728257929039407, 0.46815403871756833, 3.6605439588974997,
+                    0.48567757334944778, 3.6432189891220865, 0.5078345020817655, 3.6196872896716128,
+                    0.53538093770407091, 3.588710906907048, 0.56910302034169247, 3.5490671689020723,
+                    0.60973647145374044, 3.4996748928845411, 0.65785041569243119, 3.4397586781529919,
+                    0.7136984311221124, 3.3690430698867573, 0.77705284260528795, 3.2879532542240772,
+                    0.84705490641820569, 3.1977809591586475, 0.92212764594251773, 3.1007604045020112 } },
+                { "hires", true, hires, 0.0, 321.8122, { 1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0057 }, {
+                    0.7371312573325668e-3, 0.1442485726316185e-3, 0.5888729740967575e-4, 0.1175651343283149e-2,
+                    0.2386356198831331e-2, 0.6238968252742796e-2, 0.2849998395185769e-2, 0.2850001604814231e-2 } },
+                { "van-der-pol", true, van_der_pol, 0.0, 10.0, { 2.0, 0.0 }, { 1.9933149275686823, -0.00067040379382698448 } },
+                { "robertson", true, robertson, 0.0, 40.0, { 1.0, 0.0, 0.0 }, { 0.7158270687193, 0.9185534764529e-5, 0.2841637457458 } } };
+        return problems;
+}
+
+#endif
@@ -0,0 +1,71 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cmath>
+#include <chrono>
+#include <algorithm>
+
+#include "operators.h"
+#include <ivp.h>
+
+/* A control loop with ticks of 0.01 over Van der Pol (mu = 100, t in [0,200]), where the fast transitions make
+ * the explicit methods reject steps and take many more of them. Per-tick times (p50, p99, p99.9, max), their
+ * histogram and the most evaluations of f in a tick (which, unlike the times, does not depend on the machine), for Adaptive<Dopri> and BackwardEuler (fixed point iteration) without a budget, with a budget of
+ * evaluations of f and with a deadline. Ticks that run out of budget return the state where they got to, and the
+ * next ones catch up.
+ */
+struct VanDerPol
+{
+        std::vector<double> operator()(double t, const std::vector<double>& y) const
+        {       return std::vector<double>{ y[1], 100.0*(1.0 - y[0]*y[0])*y[1] - y[0] }; }
+};
+
+const double tick = 0.01, t_end = 200.0;
+const std::vector<double> y_ini{ 2.0, 0.0 };
+
+void report(const char* id, std::vector<double>& times, std::size_t evaluations, unsigned int incomplete, double lag)
+{
+        std::sort(times.begin(),times.end());
+        auto percentile = [&times] (double p) { return 1.e6*times[std::min(times.size() - 1,std::size_t(p*double(times.size())))]; };
+        std::cout<<"\t "<<std::left<<std::setw(34)<<id<<std::right<<std::fixed<<std::setprecision(1)
+                 <<std::setw(8)<<percentile(0.5)<<std::setw(9)<<percentile(0.99)<<std::setw(9)<<percentile(0.999)
+                 <<std::setw(9)<<1.e6*times.back()<<std::setw(10)<<evaluations<<"\t"<<std::setw(6)<<incomplete<<"\t"<<std::setprecision(3)<<lag<<std::endl;
+        std::cout<<"\t\t";
+        for (double bucket = 1.e-6; bucket < 2.0*times.back(); bucket *= 4.0)
+        {
+                std::size_t n = std::upper_bound(times.begin(),times.end(),bucket) - std::upper_bound(times.begin(),times.end(),(bucket>1.e-6)?0.25*bucket:0.0);
+                std::cout<<"<"<<std::setprecision(0)<<1.e6*bucket<<"us:"<<n<<" ";
+        }
+        std::cout<<std::endl;
+}
+
+template<typename M, typename B>
+void run(const char* id, const M& m, const B& budget)
+{
+        auto integrator = IVP::real_time_integrator(m,VanDerPol(),0.0,y_ini,t_end);
+        std::vector<double> times; std::size_t evaluations = 0; unsigned int incomplete = 0; double lag = 0.0;
+        times.reserve(std::size_t(t_end/tick) + 1);
+        for (unsigned int k = 1; double(k)*tick <= t_end; ++k)
+        {
+                auto start = std::chrono::steady_clock::now();
+                auto a = integrator.advance_to(double(k)*tick,budget());
+                times.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+                evaluations = std::max(evaluations,integrator.evaluations());
+                if (!a.complete) { ++incomplete; lag = std::max(lag,double(k)*tick - a.t); }
+        }
+        report(id,times,evaluations,incomplete,lag);
+}
+
+int main()
+{
+        const IVP::Adaptive<IVP::Dopri> dopri(1,1.e-8);
+        const IVP::BackwardEuler backward_euler(200000u,1.e-10);
+        std::cout<<int(t_end/tick)<<" ticks \t\t\t\t      p50      p99    p99.9      max (us)  max f\tincomplete\tmax lag"<<std::endl;
+        auto unbounded = [] () { return IVP::Budget(); };
+        run("Adaptive<Dopri>, unbounded",dopri,unbounded);
+        run("Adaptive<Dopri>, 100 evaluations",dopri,[] () { return IVP::evaluation_budget(100); });
+        run("Adaptive<Dopri>, 20us",dopri,[] () { return IVP::time_budget(std::chrono::microseconds(20)); });
+        run("BackwardEuler, unbounded",backward_euler,unbounded);
+        run("BackwardEuler, 100 evaluations",backward_euler,[] () { return IVP::evaluation_budget(100); });
+        run("BackwardEuler, 20us",backward_euler,[] () { return IVP::time_budget(std::chrono::microseconds(20)); });
+}
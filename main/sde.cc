@@ -0,0 +1,117 @@
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <chrono>
+#include <cstdlib>
+
+#include <ivp.h>
+
+/* Monte Carlo over geometric Brownian motion dS = mu*S dt + sigma*S dW, S(0) = 1, on [0,1], whose solution is
+ * S(1) = exp(mu - sigma^2/2 + sigma*W(1)) and E[S(1)] = exp(mu). Paths per second, weak error (of the mean, which
+ * includes the Monte Carlo error, about sigma/sqrt(paths)) and strong error (mean |S(1) - exact| on the same path):
+ *   - Euler with std::mt19937 in the lambda, as we used to hack it (one generator per path, seeded by its index)
+ *   - EulerMaruyama, Milstein and StochasticRungeKutta with a NormalStream per path
+ *   - AdaptiveStochasticRungeKutta, whose strong error is not measured (its increments come from bridges)
+ * Then the same paths on a ThreadPool, which must give the very same numbers.
+ */
+const double mu = 0.05, sigma = 0.4;
+const std::uint64_t seed = 2024;
+
+struct Result { double paths_per_second, weak, strong; };
+
+template<typename F>
+double seconds(const F& f)
+{
+        auto start = std::chrono::steady_clock::now();
+        f();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/* W(1) of a path whose steps drew one normal each */
+double wiener(std::uint64_t path, unsigned int steps)
+{
+        IVP::NormalStream noise(seed,path);
+        double w = 0.0;
+        for (unsigned int i = 0; i<steps; ++i) w += noise();
+        return w*std::sqrt(1.0/steps);
+}
+
+/* solve(path) returns S(1); w(path) returns W(1), or NaN if unknown */
+template<typename Solve, typename Wiener>
+Result monte_carlo(std::size_t paths, const Solve& solve, const Wiener& w)
+{
+        double mean = 0.0, strong = 0.0;
+        std::vector<double> s(paths);
+        double t = seconds([&] () { for (std::size_t p = 0; p<paths; ++p) s[p] = solve(p); });
+        for (std::size_t p = 0; p<paths; ++p)
+        {
+                mean += s[p];
+                double wp = w(p);
+                if (!std::isnan(wp)) strong += std::fabs(s[p] - std::exp(mu - 0.5*sigma*sigma + sigma*wp));
+        }
+        return Result{ double(paths)/t, std::fabs(mean/paths - std::exp(mu)), strong/paths };
+}
+
+void report(const std::string& id, const Result& r, bool strong = true)
+{
+        std::cout<<"\t "<<std::left<<std::setw(34)<<id<<std::right<<std::fixed<<std::setprecision(0)<<std::setw(10)
+                 <<r.paths_per_second<<"\t"<<std::scientific<<std::setprecision(2)<<r.weak<<"\t";
+        if (strong) std::cout<<r.strong; else std::cout<<"  -";
+        std::cout<<std::endl;
+}
+
+int main(int argc, char** argv)
+{
+        const std::size_t paths = (argc > 1)?std::size_t(std::atof(argv[1])):std::size_t(100000);
+        auto f  = [] (double t, double s) { return mu*s; };
+        auto g  = [] (double t, double s) { return sigma*s; };
+        auto dg = [] (double t, double s) { return sigma; };
+        auto none = [] (std::size_t) { return std::nan(""); };
+
+        for (unsigned int steps : { 16, 64, 256 })
+        {
+                std::cout<<"GBM, "<<paths<<" paths, "<<steps<<" steps\t\t paths/s\t weak error\t strong error"<<std::endl;
+                auto w = [steps] (std::size_t p) { return wiener(p,steps); };
+                report("Euler + std::mt19937 lambda",monte_carlo(paths,[&] (std::size_t p)
+                {
+                        std::mt19937 generator(p);
+                        std::normal_distribution<double> normal;
+                        double h = 1.0/steps;
+                        return IVP::Euler(int(steps)).solve([&] (double t, double s) { return mu*s + sigma*s*normal(generator)/std::sqrt(h); },0.0,1.0,1.0);
+                },none),false);
+                report("EulerMaruyama",monte_carlo(paths,[&] (std::size_t p)
+                {       return IVP::EulerMaruyama(int(steps)).solve(IVP::sde_problem(f,g,IVP::NormalStream(seed,p)),0.0,1.0,1.0); },w));
+                report("Milstein",monte_carlo(paths,[&] (std::size_t p)
+                {       return IVP::Milstein(int(steps)).solve(IVP::sde_problem(f,g,dg,IVP::NormalStream(seed,p)),0.0,1.0,1.0); },w));
+                report("StochasticRungeKutta",monte_carlo(paths,[&] (std::size_t p)
+                {       return IVP::StochasticRungeKutta(int(steps)).solve(IVP::sde_problem(f,g,IVP::NormalStream(seed,p)),0.0,1.0,1.0); },w));
+        }
+
+        std::cout<<"GBM, "<<paths<<" paths, adaptive\t\t paths/s\t weak error\t steps/path"<<std::endl;
+        for (double tolerance : { 1.e-2, 1.e-3, 1.e-4 })
+        {
+                std::size_t steps = 0;
+                IVP::AdaptiveStochasticRungeKutta<> srk(16,tolerance);
+                Result r = monte_carlo(paths,[&] (std::size_t p)
+                {
+                        double s = 1.0;
+                        for (const auto& step : srk.steps(IVP::sde_problem(f,g,IVP::NormalStream(seed,p)),0.0,1.0,1.0)) { s = step.y(); ++steps; }
+                        --steps;
+                        return s;
+                },none);
+                r.strong = double(steps)/paths;
+                std::ostringstream id; id<<"AdaptiveStochasticRungeKutta "<<std::scientific<<std::setprecision(0)<<tolerance;
+                report(id.str(),r);
+        }
+
+        IVP::ThreadPool pool(3);
+        std::vector<double> serial(paths), parallel(paths);
+        IVP::EulerMaruyama em(64);
+        for (std::size_t p = 0; p<paths; ++p) serial[p] = em.solve(IVP::sde_problem(f,g,IVP::NormalStream(seed,p)),0.0,1.0,1.0);
+        pool.parallel_for(paths,[&] (std::size_t p) { parallel[p] = em.solve(IVP::sde_problem(f,g,IVP::NormalStream(seed,p)),0.0,1.0,1.0); });
+        std::cout<<"ThreadPool("<<pool.size()<<" threads) paths identical to serial: "<<((serial == parallel)?"yes":"no")<<std::endl;
+}
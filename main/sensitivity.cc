@@ -0,0 +1,108 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <array>
+#include <cmath>
+#include <chrono>
+
+#include "operators.h"
+#include <ivp.h>
+
+/* dy/dp of Lotka-Volterra x' = a x - b x y, y' = d x y - c y at t = 10, with p = (a, b, c, d):
+ * forward sensitivities on a single adaptive solve against forward finite differences (P+1 adaptive solves).
+ * Error control is on y only, so both use the same steps for the unperturbed problem.
+ *
+ * Sensitivities are not cheaper here: a step combines y and the P columns, as many vectors as the P+1 solves,
+ * plus the Jacobian products, and with 2 variables the cost is that of allocating them. They are more accurate
+ * at the same tolerance, which is what they are for.
+ */
+using State = std::vector<double>;
+using Parameters = std::array<double,4>;
+
+struct Jacobian
+{
+        double a00, a01, a10, a11;
+};
+
+State operator*(const Jacobian& j, const State& v)
+{       return State{ j.a00*v[0] + j.a01*v[1], j.a10*v[0] + j.a11*v[1] }; }
+
+struct LotkaVolterra
+{
+        Parameters p;
+        State operator()(double t, const State& y) const
+        {       return State{ p[0]*y[0] - p[1]*y[0]*y[1], p[3]*y[0]*y[1] - p[2]*y[1] }; }
+};
+
+struct LotkaVolterraDfdy
+{
+        Parameters p;
+        Jacobian operator()(double t, const State& y) const
+        {       return Jacobian{ p[0] - p[1]*y[1], -p[1]*y[0], p[3]*y[1], p[3]*y[0] - p[2] }; }
+};
+
+struct LotkaVolterraDfdp
+{
+        std::array<State,4> operator()(double t, const State& y) const
+        {       return {{ State{ y[0], 0.0 }, State{ -y[0]*y[1], 0.0 }, State{ 0.0, -y[1] }, State{ 0.0, y[0]*y[1] } }}; }
+};
+
+const Parameters p = {{ 1.5, 1.0, 3.0, 1.0 }};
+const State y_ini = { 1.0, 1.0 };
+const double b = 10.0;
+
+template<typename M>
+std::vector<State> sensitivities(const M& m)
+{
+        auto f = IVP::forward_sensitivity(LotkaVolterra{p},LotkaVolterraDfdy{p},LotkaVolterraDfdp());
+        return m.solve(f,0.0,IVP::sensitivity_state(y_ini,4),b).s;
+}
+
+template<typename M>
+std::vector<State> finite_differences(const M& m)
+{
+        State y = m.solve(LotkaVolterra{p},0.0,y_ini,b);
+        std::vector<State> sol;
+        for (std::size_t j = 0; j<p.size(); ++j)
+        {
+                Parameters pj = p; double delta = 1.e-7*std::max(1.0,std::fabs(p[j])); pj[j] += delta;
+                sol.push_back((m.solve(LotkaVolterra{pj},0.0,y_ini,b) - y)/delta);
+        }
+        return sol;
+}
+
+double error(const std::vector<State>& s, const std::vector<State>& reference)
+{
+        double sol = 0.0;
+        for (std::size_t j = 0; j<s.size(); ++j) for (std::size_t i = 0; i<s[j].size(); ++i)
+                sol = std::max(sol,std::fabs(s[j][i] - reference[j][i])/std::max(1.0,std::fabs(reference[j][i])));
+        return sol;
+}
+
+template<typename F>
+double seconds_per_run(const F& f)
+{
+        f(); unsigned int n=0;
+        std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+        while (std::chrono::duration<double>(std::chrono::system_clock::now() - start).count()<=0.2)
+        {       f(); n++; }
+        return std::chrono::duration<double>(std::chrono::system_clock::now() - start).count()/double(n);
+}
+
+int main(int argc, char** argv)
+{
+        std::vector<State> reference = sensitivities(IVP::RungeKutta4(100000));
+
+        std::cout<<"Lotka-Volterra, dy(10)/dp for 4 parameters, relative error against RK4 with 10^5 steps"<<std::endl;
+        std::cout<<" tolerance\t  sensitivity (error / time) \t  finite differences (error / time)"<<std::endl;
+        for (double tol : { 1.e-3, 1.e-4, 1.e-5, 1.e-6, 1.e-7, 1.e-8 })
+        {
+                IVP::Adaptive<IVP::Dopri,IVP::SensitivityErrorEstimator<>> dopri(10,tol);
+                std::vector<State> s, fd;
+                double ts = seconds_per_run([&] () { s = sensitivities(dopri); });
+                double tfd = seconds_per_run([&] () { fd = finite_differences(dopri); });
+                std::cout<<std::scientific<<std::setprecision(0)<<"  "<<tol<<"\t"<<std::setprecision(2)
+                         <<error(s,reference)<<" "<<std::fixed<<std::setw(9)<<1.e6*ts<<"us\t\t"<<std::scientific
+                         <<error(fd,reference)<<" "<<std::fixed<<std::setw(9)<<1.e6*tfd<<"us"<<std::endl;
+        }
+}
@@ -0,0 +1,82 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cmath>
+#include <chrono>
+#include <thread>
+#include <memory>
+#include <algorithm>
+
+#include "operators.h"
+#include <ivp.h>
+
+/* Multiple shooting with Adaptive<Dopri> on each segment, against the number of segments (1 is single shooting),
+ * serially and on a ThreadPool with a thread per core:
+ *   - Troesch's problem y'' = mu*sinh(mu*y), y(0) = 0, y(1) = 1, from the guess y = t: y'(0) is small and the
+ *     initial value problems from the guess blow up before t = 1 unless the segments are short.
+ *   - y'' = 100*y, y(0) = y(4) = 1, from the guess y = 1, whose solution (sinh(10*(4 - t)) + sinh(10*t))/sinh(40)
+ *     is about 4e-9 at t = 2: single shooting gets y'(0) from a matrix with entries of e^40, and the error at the
+ *     nodes grows with exp(10*segment length).
+ */
+struct Troesch
+{
+        double mu;
+        template<typename T>
+        std::vector<T> operator()(double t, const std::vector<T>& y) const
+        {       return std::vector<T>{ y[1], mu*sinh(mu*y[0]) }; }
+};
+
+struct Exponential
+{
+        template<typename T>
+        std::vector<T> operator()(double t, const std::vector<T>& y) const
+        {       return std::vector<T>{ y[1], 100.0*y[0] }; }
+};
+
+template<typename F>
+double seconds(const F& f)
+{
+        auto start = std::chrono::steady_clock::now();
+        f();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main()
+{
+        using std::sinh;
+        const std::size_t cores = std::max(1u,std::thread::hardware_concurrency());
+        auto pool = std::make_shared<IVP::ThreadPool>(cores - 1);
+        const IVP::Adaptive<IVP::Dopri> dopri(1,1.e-10);
+        auto bc = [] (const std::vector<double>& ya, const std::vector<double>& yb) { return std::vector<double>{ ya[0], yb[0] - 1.0 }; };
+        auto guess = [] (double t) { return std::vector<double>{ t, 1.0 }; };
+
+        for (double mu : { 2.0, 5.0 })
+        {
+                std::cout<<"Troesch, mu = "<<std::fixed<<std::setprecision(0)<<mu<<"\t iterations\t residual\t y'(0)\t\t serial\t\t "<<pool->size()<<" threads"<<std::endl;
+                for (unsigned int segments : { 1, 2, 4, 8, 16, 32, 64 })
+                {
+                        IVP::BVPSolution<std::vector<double>,double> sol;
+                        double serial = seconds([&] () { sol = IVP::multiple_shooting(dopri,segments,1.e-9).solve(Troesch{mu},bc,0.0,1.0,guess); });
+                        double parallel = seconds([&] () { IVP::multiple_shooting(dopri,segments,1.e-9,50,pool).solve(Troesch{mu},bc,0.0,1.0,guess); });
+                        std::cout<<"\t "<<std::setw(2)<<segments<<" segments\t "<<std::setw(4)<<sol.iterations<<"\t\t "<<std::scientific
+                                 <<std::setprecision(2)<<sol.residual<<"\t ";
+                        if (sol.converged) std::cout<<std::setprecision(8)<<sol.y[0][1]; else std::cout<<"(diverged)    ";
+                        std::cout<<std::fixed<<std::setprecision(2)<<"\t "<<1.e3*serial<<" ms\t "<<1.e3*parallel<<" ms"<<std::endl;
+                }
+        }
+
+        auto bc1 = [] (const std::vector<double>& ya, const std::vector<double>& yb) { return std::vector<double>{ ya[0] - 1.0, yb[0] - 1.0 }; };
+        auto one = [] (double t) { return std::vector<double>{ 1.0, 0.0 }; };
+        auto exact = [] (double t) { return (std::sinh(10.0*(4.0 - t)) + std::sinh(10.0*t))/std::sinh(40.0); };
+        std::cout<<"y'' = 100*y on [0,4]	 iterations	 residual	 error at nodes	 serial		 "<<pool->size()<<" threads"<<std::endl;
+        for (unsigned int segments : { 1, 2, 4, 8, 16, 32, 64 })
+        {
+                IVP::BVPSolution<std::vector<double>,double> sol;
+                double serial = seconds([&] () { sol = IVP::multiple_shooting(dopri,segments,1.e-9).solve(Exponential(),bc1,0.0,4.0,one); });
+                double parallel = seconds([&] () { IVP::multiple_shooting(dopri,segments,1.e-9,50,pool).solve(Exponential(),bc1,0.0,4.0,one); });
+                double error = 0.0;
+                for (std::size_t k = 0; k<sol.t.size(); ++k) error = std::max(error,std::fabs(sol.y[k][0] - exact(sol.t[k])));
+                std::cout<<"\t "<<std::setw(2)<<segments<<" segments\t "<<std::setw(4)<<sol.iterations<<"\t\t "<<std::scientific
+                         <<std::setprecision(2)<<sol.residual<<"\t "<<error<<"\t"<<std::fixed<<"\t "<<1.e3*serial<<" ms\t "<<1.e3*parallel<<" ms"<<std::endl;
+        }
+}
@@ -0,0 +1,123 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cmath>
+#include <chrono>
+
+#include "operators.h"
+#include <ivp.h>
+
+/* Operator splitting:
+ *   - Kepler orbit (e = 0.6, one period) split into drift and kick, both integrated exactly by a single Euler
+ *     step: Lie is symplectic Euler, Strang is Stormer-Verlet and Yoshida is fourth order.
+ *   - Allen-Cahn y_t = D*y_xx + y - y^3 (100 points, [0,2]) split into reaction (Adaptive<Dopri>) and diffusion
+ *     (ARK4(3)6L with a zero nonlinear part, one step per flow, its factorization kept between steps), against
+ *     the IMEX method over the whole problem.
+ */
+unsigned long evaluations = 0;
+
+struct Drift
+{
+        template<typename real>
+        std::vector<double> operator()(const real& t, const std::vector<double>& y) const
+        {       return std::vector<double>{ y[2], y[3], 0.0, 0.0 }; }
+};
+
+struct Kick
+{
+        template<typename real>
+        std::vector<double> operator()(const real& t, const std::vector<double>& y) const
+        {
+                ++evaluations;
+                double r = std::sqrt(y[0]*y[0] + y[1]*y[1]);
+                double r3 = r*r*r;
+                return std::vector<double>{ 0.0, 0.0, -y[0]/r3, -y[1]/r3 };
+        }
+};
+
+struct Reaction
+{
+        template<typename real>
+        std::vector<double> operator()(const real& t, const std::vector<double>& y) const
+        {
+                ++evaluations;
+                std::vector<double> sol(y.size());
+                for (std::size_t i = 0; i<y.size(); ++i) sol[i] = y[i] - y[i]*y[i]*y[i];
+                return sol;
+        }
+};
+
+struct Zero
+{
+        template<typename real>
+        std::vector<double> operator()(const real& t, const std::vector<double>& y) const
+        {       return std::vector<double>(y.size(),0.0); }
+};
+
+template<typename F>
+double seconds(const F& f)
+{
+        std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+        f();
+        return std::chrono::duration<double>(std::chrono::system_clock::now() - start).count();
+}
+
+double distance(const std::vector<double>& a, const std::vector<double>& b)
+{
+        double sol = 0.0;
+        for (std::size_t i = 0; i<a.size(); ++i) sol = std::max(sol, std::fabs(a[i] - b[i]));
+        return sol;
+}
+
+template<typename M, typename F>
+void run(const char* id, const M& m, const F& f, const std::vector<double>& y_ini, double b, const std::vector<double>& reference)
+{
+        std::vector<double> y;
+        evaluations = 0;
+        double t = seconds([&] () { y = m.solve(f,0.0,y_ini,b); });
+        std::cout<<"\t "<<id<<"\t"<<std::scientific<<std::setprecision(2)<<distance(y,reference)<<"\t"
+                 <<std::setw(9)<<evaluations<<"\t"<<std::fixed<<std::setw(9)<<1.e3*t<<"ms"<<std::endl;
+}
+
+int main(int argc, char** argv)
+{
+        const double pi = 3.14159265358979323846, e = 0.6;
+        std::vector<double> kepler{ 1.0 - e, 0.0, 0.0, std::sqrt((1.0 + e)/(1.0 - e)) };
+        auto orbit = IVP::split_problem(Drift(),Kick());
+
+        std::cout<<"Kepler, e = 0.6, one period, drift + kick\t error \t\t kicks \t\t time"<<std::endl;
+        for (unsigned int steps : { 200u, 1000u, 5000u })
+        {
+                std::cout<<"  "<<steps<<" steps"<<std::endl;
+                run("Lie             ",IVP::lie_splitting(steps,IVP::Euler(1),IVP::Euler(1)),orbit,kepler,2.0*pi,kepler);
+                run("Strang          ",IVP::strang_splitting(steps,IVP::Euler(1),IVP::Euler(1)),orbit,kepler,2.0*pi,kepler);
+                run("Yoshida         ",IVP::yoshida_splitting(steps,IVP::Euler(1),IVP::Euler(1)),orbit,kepler,2.0*pi,kepler);
+        }
+
+        const std::size_t n = 100;
+        const double d = 0.5, dx = 1.0/double(n + 1);
+        IVP::DenseMatrix<double> laplacian(n,n);
+        for (std::size_t i = 0; i<n; ++i)
+        {
+                laplacian(i,i) = -2.0*d/(dx*dx);
+                if (i>0)   laplacian(i,i-1) = d/(dx*dx);
+                if (i+1<n) laplacian(i,i+1) = d/(dx*dx);
+        }
+        std::vector<double> y_ini(n);
+        for (std::size_t i = 0; i<n; ++i) y_ini[i] = 0.5*std::sin(pi*double(i + 1)*dx) + 0.3*std::sin(5.0*pi*double(i + 1)*dx);
+        auto c1 = [&laplacian] (double t) -> const IVP::DenseMatrix<double>& { return laplacian; };
+        auto c0 = [n] (double t) { return std::vector<double>(n,0.0); };
+
+        auto whole = IVP::additive_problem(c1,c0,Reaction());
+        auto parts = IVP::split_problem(Reaction(),IVP::additive_problem(c1,c0,Zero()));
+        std::vector<double> reference = IVP::Adaptive<IVP::ARK436L2SA>(100,1.e-12).solve(whole,0.0,y_ini,2.0);
+
+        std::cout<<std::endl<<"Allen-Cahn, "<<n<<" points, [0,2], reaction + diffusion\t error \t\t reactions \t time"<<std::endl;
+        for (unsigned int steps : { 20u, 100u, 500u })
+        {
+                std::cout<<"  "<<steps<<" steps"<<std::endl;
+                run("Lie             ",IVP::lie_splitting(steps,IVP::Adaptive<IVP::Dopri>(1,1.e-8),IVP::ARK436L2SA(1)),parts,y_ini,2.0,reference);
+                run("Strang          ",IVP::strang_splitting(steps,IVP::Adaptive<IVP::Dopri>(1,1.e-8),IVP::ARK436L2SA(1)),parts,y_ini,2.0,reference);
+                run("ARK4(3)6L (IMEX)",IVP::ARK436L2SA(steps),whole,y_ini,2.0,reference);
+        }
+}
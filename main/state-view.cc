@@ -0,0 +1,43 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cmath>
+#include <stdexcept>
+
+#include <ivp.h>
+#include <methods/state-view.h>
+
+/* StateView as YType: Adaptive<Dopri> on y' = -k*y over a buffer that belongs to someone else (here, a
+ * std::vector), with solve (which returns a state of its own) and solve_inplace (which writes the solution
+ * through the view, into the buffer). Assigning a state of another size to a view throws.
+ */
+struct Decay
+{
+        template<typename real>
+        IVP::StateView<double> operator()(const real& t, const IVP::StateView<double>& y) const
+        {
+                IVP::StateView<double> sol(y.size());
+                for (std::size_t i = 0; i<y.size(); ++i) sol[i] = -double(i + 1)*y[i];
+                return sol;
+        }
+};
+
+int main()
+{
+        std::vector<double> buffer(4,1.0);
+        IVP::StateView<double> y(buffer);
+        const IVP::Adaptive<IVP::Dopri> dopri(1,1.e-10);
+
+        IVP::StateView<double> sol = dopri.solve(Decay(),0.0,y,1.0);
+        std::cout<<"solve:         "<<(sol.is_view()?"view":"owned")<<"\t";
+        for (std::size_t i = 0; i<sol.size(); ++i) std::cout<<std::scientific<<std::setprecision(2)<<std::fabs(sol[i] - std::exp(-double(i + 1)))<<" ";
+        std::cout<<"\t buffer untouched: "<<std::boolalpha<<(buffer[0] == 1.0)<<std::endl;
+
+        dopri.solve_inplace(Decay(),0.0,y,1.0);
+        std::cout<<"solve_inplace: "<<(y.is_view()?"view":"owned")<<"\t";
+        for (std::size_t i = 0; i<buffer.size(); ++i) std::cout<<std::fabs(buffer[i] - std::exp(-double(i + 1)))<<" ";
+        std::cout<<"\t (errors, read from the buffer)"<<std::endl;
+
+        try { y = IVP::StateView<double>(3); std::cout<<"size mismatch not detected"<<std::endl; return 1; }
+        catch (const std::invalid_argument& e) { std::cout<<"size mismatch:  "<<e.what()<<std::endl; }
+}
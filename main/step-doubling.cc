@@ -0,0 +1,95 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cmath>
+#include <chrono>
+#include <thread>
+
+#include "operators.h"
+#include <ivp.h>
+
+/* Step doubling (non embedded Adaptive over RungeKutta4) with the full step on a helper thread, against the
+ * serial one. The overhead is the time per accepted step over the time of a plain RungeKutta4 step:
+ *   - 64 softened gravitating bodies over [0,1], an expensive f (O(n^2)),
+ *   - Arenstorf orbit over one period, a cheap f (the handoff latency dominates).
+ */
+struct Arenstorf
+{
+        template<typename real>
+        std::vector<double> operator()(const real& t, const std::vector<double>& y) const
+        {
+                const double mu = 0.012277471, nu = 1.0 - mu;
+                double d1 = std::pow((y[0] + mu)*(y[0] + mu) + y[1]*y[1],1.5);
+                double d2 = std::pow((y[0] - nu)*(y[0] - nu) + y[1]*y[1],1.5);
+                return std::vector<double>{ y[2], y[3],
+                        y[0] + 2.0*y[3] - nu*(y[0] + mu)/d1 - mu*(y[0] - nu)/d2,
+                        y[1] - 2.0*y[2] - nu*y[1]/d1 - mu*y[1]/d2 };
+        }
+};
+
+/* State (x_i, y_i, vx_i, vy_i) per body */
+struct Bodies
+{
+        template<typename real>
+        std::vector<double> operator()(const real& t, const std::vector<double>& y) const
+        {
+                std::size_t n = y.size()/4;
+                std::vector<double> sol(y.size(),0.0);
+                for (std::size_t i = 0; i<n; ++i)
+                {
+                        sol[4*i] = y[4*i+2]; sol[4*i+1] = y[4*i+3];
+                        for (std::size_t j = 0; j<n; ++j) if (j != i)
+                        {
+                                double dx = y[4*j] - y[4*i], dy = y[4*j+1] - y[4*i+1];
+                                double r2 = dx*dx + dy*dy + 0.01, inv = 1.0/(double(n)*r2*std::sqrt(r2));
+                                sol[4*i+2] += dx*inv; sol[4*i+3] += dy*inv;
+                        }
+                }
+                return sol;
+        }
+};
+
+template<typename F>
+double seconds(const F& f)
+{
+        std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+        f();
+        return std::chrono::duration<double>(std::chrono::system_clock::now() - start).count();
+}
+
+template<typename F>
+void run(const char* id, const F& f, const std::vector<double>& y_ini, double b, double tol)
+{
+        std::size_t steps = 0;
+        IVP::Adaptive<IVP::RungeKutta4> serial(100,tol), parallel(100,tol);
+        parallel.set_parallel(true);
+        std::vector<double> y_serial, y_parallel;
+        double t_serial   = seconds([&] () { for (const auto& s : serial.steps(f,0.0,y_ini,b)) { y_serial = s.y(); ++steps; } });
+        double t_parallel = seconds([&] () { y_parallel = parallel.solve(f,0.0,y_ini,b); });
+        double t_plain    = seconds([&] () { IVP::RungeKutta4(int(steps)).solve(f,0.0,y_ini,b); });
+        double per_step = t_plain/double(steps);
+        std::cout<<"\t "<<id<<std::setw(7)<<steps<<"\t"<<std::fixed<<std::setprecision(2)
+                 <<std::setw(9)<<1.e3*t_serial<<"ms ("<<t_serial/(per_step*steps)<<"x)\t"
+                 <<std::setw(9)<<1.e3*t_parallel<<"ms ("<<t_parallel/(per_step*steps)<<"x)\t"
+                 <<((y_serial == y_parallel)?"same":"DIFFERENT")<<std::endl;
+}
+
+int main(int argc, char** argv)
+{
+        const std::size_t n = 64;
+        const double pi = 3.14159265358979323846;
+        std::vector<double> bodies(4*n);
+        for (std::size_t i = 0; i<n; ++i)
+        {
+                double a = 2.0*pi*double(i)/double(n), r = 1.0 + 0.1*std::sin(3.0*a);
+                bodies[4*i] = r*std::cos(a); bodies[4*i+1] = r*std::sin(a);
+                bodies[4*i+2] = -0.8*std::sin(a); bodies[4*i+3] = 0.8*std::cos(a);
+        }
+        std::vector<double> arenstorf{ 0.994, 0.0, 0.0, -2.00158510637908252240537862224 };
+
+        std::cout<<"Adaptive<RungeKutta4> ("<<std::thread::hardware_concurrency()<<" hardware threads)"<<std::endl;
+        std::cout<<"\t\t\t steps \t serial (overhead)\t parallel (overhead)\t result"<<std::endl;
+        run("64 bodies, 1e-6 ",Bodies(),bodies,1.0,1.e-6);
+        run("64 bodies, 1e-9 ",Bodies(),bodies,1.0,1.e-9);
+        run("Arenstorf, 1e-6 ",Arenstorf(),arenstorf,17.0652165601579625588917206249,1.e-6);
+}
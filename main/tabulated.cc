@@ -0,0 +1,99 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <algorithm>
+#include <cmath>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+
+#include <ivp.h>
+
+/* Linear problem y' = c1(t)*y + c0(t) with coefficients sampled in files of n samples each (4*10^6 by default, or
+ * the first argument), solved with RK4 over the whole table:
+ *   - vectors: the files read into std::vector, and lambdas that binary search them at every evaluation
+ *   - TabulatedFunction: the files memory mapped, with the cursor lookup, linear or cubic
+ * Startup is the time to get the coefficients ready, solve the time to integrate.
+ */
+template<typename F>
+double seconds(const F& f)
+{
+        auto start = std::chrono::steady_clock::now();
+        f();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/* Reads back the layout of write_tabulated */
+void read_table(const std::string& file, std::vector<double>& ts, std::vector<double>& vs)
+{
+        std::ifstream in(file,std::ios::binary);
+        char magic[8]; std::uint64_t n;
+        in.read(magic,8); in.read(reinterpret_cast<char*>(&n),sizeof(n));
+        std::vector<double> pairs(2*n);
+        in.read(reinterpret_cast<char*>(pairs.data()),std::streamsize(sizeof(double)*pairs.size()));
+        ts.resize(n); vs.resize(n);
+        for (std::size_t i = 0; i<n; ++i) { ts[i] = pairs[2*i]; vs[i] = pairs[2*i + 1]; }
+}
+
+struct Searched
+{
+        const std::vector<double>* ts; const std::vector<double>* vs;
+        double operator()(double t) const
+        {
+                std::size_t i = std::upper_bound(ts->begin(),ts->end(),t) - ts->begin();
+                if (i == 0) return vs->front();
+                if (i == ts->size()) return vs->back();
+                double u = (t - (*ts)[i - 1])/((*ts)[i] - (*ts)[i - 1]);
+                return (*vs)[i - 1] + u*((*vs)[i] - (*vs)[i - 1]);
+        }
+};
+
+void report(const char* id, double startup, double solve, double y)
+{
+        std::cout<<"\t "<<std::left<<std::setw(26)<<id<<std::right<<std::fixed<<std::setprecision(2)
+                 <<std::setw(10)<<1.e3*startup<<" ms"<<std::setw(10)<<1.e3*solve<<" ms\t"<<std::setprecision(10)<<y<<std::endl;
+}
+
+int main(int argc, char** argv)
+{
+        const std::size_t n = (argc > 1)?std::size_t(std::atof(argv[1])):std::size_t(4000000);
+        const double t_end = 100.0;
+        const std::string file1 = "ivp-c1.tab", file0 = "ivp-c0.tab";
+        {
+                std::vector<double> ts(n), v1(n), v0(n);
+                for (std::size_t i = 0; i<n; ++i)
+                {
+                        ts[i] = t_end*double(i)/double(n - 1);
+                        v1[i] = -1.0 - 0.5*std::sin(ts[i]);
+                        v0[i] = std::cos(3.0*ts[i]);
+                }
+                IVP::write_tabulated(file1,ts,v1);
+                IVP::write_tabulated(file0,ts,v0);
+        }
+
+        const IVP::RungeKutta4 rk4(1000000u);
+        std::cout<<n<<" samples, RK4 with 10^6 steps\t startup\t solve\t\t y("<<t_end<<")"<<std::endl;
+        {
+                std::vector<double> ts1, v1, ts0, v0;
+                double startup = seconds([&] () { read_table(file1,ts1,v1); read_table(file0,ts0,v0); });
+                double y;
+                double solve = seconds([&] () { y = rk4.solve(IVP::linear_problem(Searched{&ts1,&v1},Searched{&ts0,&v0}),0.0,1.0,t_end); });
+                report("vectors + binary search",startup,solve,y);
+        }
+        for (auto interpolation : { IVP::Interpolation::Linear, IVP::Interpolation::Cubic })
+        {
+                std::vector<IVP::TabulatedFunction> c;
+                double startup = seconds([&] ()
+                {
+                        c.emplace_back(file1,interpolation);
+                        c.emplace_back(file0,interpolation);
+                });
+                double y;
+                double solve = seconds([&] () { y = rk4.solve(IVP::linear_problem(c[0],c[1]),0.0,1.0,t_end); });
+                report((interpolation == IVP::Interpolation::Linear)?"TabulatedFunction linear":"TabulatedFunction cubic",startup,solve,y);
+        }
+        std::remove(file1.c_str()); std::remove(file0.c_str());
+}
@@ -0,0 +1,52 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cmath>
+#include <chrono>
+#include <filesystem>
+
+#include "operators.h"
+#include <ivp.h>
+
+/* Timeline of an integration (this target is built with IVP_TRACING):
+ *   trace [output.json]
+ * solves the Arenstorf orbit with Adaptive<Dopri> and with step doubling on a helper thread, recording every step,
+ * attempt and evaluation of f, and writes them in the Chrome trace format (open it in chrome://tracing or
+ * https://ui.perfetto.dev). If /sys/kernel/tracing/trace_marker is writable the events also go to ftrace.
+ */
+std::vector<double> arenstorf(double t, const std::vector<double>& y)
+{
+        const double mu = 0.012277471, nu = 1.0 - mu;
+        double d1 = std::pow((y[0] + mu)*(y[0] + mu) + y[1]*y[1],1.5);
+        double d2 = std::pow((y[0] - nu)*(y[0] - nu) + y[1]*y[1],1.5);
+        return std::vector<double>{ y[2], y[3],
+                y[0] + 2.0*y[3] - nu*(y[0] + mu)/d1 - mu*(y[0] - nu)/d2,
+                y[1] - 2.0*y[2] - nu*y[1]/d1 - mu*y[1]/d2 };
+}
+
+template<typename M>
+void run(const char* name, const M& method)
+{
+        const double period = 17.0652165601579625588917206249;
+        std::vector<double> y_ini{ 0.994, 0.0, 0.0, -2.00158510637908252240537862224 };
+        std::size_t before = IVP::trace::size(), steps = 0;
+        for (const auto& s : method.steps(IVP::trace::traced(arenstorf),0.0,y_ini,period)) { (void)s; ++steps; }
+        std::cout<<"\t "<<std::left<<std::setw(28)<<name<<std::right<<std::setw(8)<<steps<<"\t"
+                 <<std::setw(8)<<(IVP::trace::size() - before)<<std::endl;
+}
+
+int main(int argc, char** argv)
+{
+        std::string file = (argc>1)?argv[1]:(std::filesystem::temp_directory_path()/"ivp-trace.json").string();
+        bool markers = IVP::trace::open_markers();
+
+        std::cout<<"Arenstorf orbit, one period \t steps \t\t events"<<std::endl;
+        run("Adaptive<Dopri>",IVP::Adaptive<IVP::Dopri>(100,1.e-7));
+        IVP::Adaptive<IVP::RungeKutta4> doubling(100,1.e-7);
+        doubling.set_parallel(true);
+        run("Adaptive<RungeKutta4> (2 thr.)",doubling);
+
+        IVP::trace::close_markers();
+        if (!IVP::trace::write_chrome_trace(file)) { std::cerr<<"Cannot write "<<file<<std::endl; return 1; }
+        std::cout<<IVP::trace::size()<<" events written to "<<file<<(markers?" (and to ftrace)":"")<<std::endl;
+}
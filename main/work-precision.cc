@@ -0,0 +1,104 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <cmath>
+#include <chrono>
+#include <algorithm>
+
+#include "operators.h"
+#include <ivp.h>
+#include "problems.h"
+
+/* Work-precision data (with the methods of the ivp-any-solver library):
+ *   work-precision [problem | method ...] > data.csv
+ * solves every test problem (see problems.h) with every method, sweeping the tolerance of the adaptive ones from
+ * 1e-3 to 1e-12 and doubling the steps of the fixed step ones from 16 on, and writes one CSV line per run with
+ * the error at the end of the interval, max_i |y_i - r_i|/max(|r_i|, 1e-6), the time per solve and the number of
+ * evaluations of f. Adaptive methods start with a step of 1/10000 of the interval (a larger first step blows up
+ * the stiff problems), and a method stops refining once a solve takes longer than max_time. Names given as
+ * arguments restrict the problems and/or methods.
+ *   work-precision --reference [problem ...]
+ * computes the reference solutions again (BulirschStoer at tolerance 1e-14).
+ */
+const double max_time = 0.25;
+
+double error(const std::vector<double>& y, const std::vector<double>& reference)
+{
+        double sol = 0.0;
+        for (std::size_t i = 0; i<y.size(); ++i)
+        {
+                double e = std::fabs(y[i] - reference[i])/std::max(std::fabs(reference[i]),1.e-6);
+                if (!(e <= sol)) sol = e; //NaN counts as the largest error
+        }
+        return sol;
+}
+
+/* Time per solve (repeating it for at least 10ms), and evaluations of f per solve */
+double measure(const IVP::AnySolver<std::vector<double>>& solver, const TestProblem& p, std::vector<double>& y, std::size_t& evaluations)
+{
+        std::size_t count = 0;
+        auto f = [&p, &count] (double t, const std::vector<double>& y) { ++count; return p.f(t,y); };
+        unsigned int n = 0; double elapsed;
+        auto start = std::chrono::steady_clock::now();
+        do
+        {
+                y = solver.solve(f,p.t_ini,p.y_ini,p.t_end); ++n;
+                elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        } while (elapsed < 1.e-2);
+        evaluations = count/n;
+        return elapsed/double(n);
+}
+
+void sweep(const TestProblem& p, const std::string& method)
+{
+        bool adaptive = (method.compare(0,9,"adaptive-") == 0) || (method == "bulirsch-stoer");
+        unsigned int steps = adaptive?10000:16;
+        double tolerance = adaptive?1.e-3:1.e-10;
+        for (unsigned int run = 0; run < (adaptive?10u:20u); ++run)
+        {
+                std::vector<double> y; std::size_t evaluations = 0;
+                double seconds = 0.0, e;
+                //Implicit solvers that do not converge (steps too large) and step sizes that underflow (BulirschStoer on
+                //stiff problems) count as an infinite error
+                try { seconds = measure(IVP::any_solver<std::vector<double>>(method,steps,tolerance),p,y,evaluations); e = error(y,p.reference); }
+                catch (const IVP::ImplicitSolverError&) { e = HUGE_VAL; }
+                catch (const IVP::StepSizeUnderflow&)   { e = HUGE_VAL; }
+                std::cout<<p.name<<','<<method<<','<<steps<<','<<std::scientific<<std::setprecision(1)<<tolerance<<','
+                         <<std::setprecision(3)<<e<<','<<seconds<<','<<evaluations<<std::endl;
+                if ((seconds > max_time) || (e < 1.e-12)) break;
+                if (adaptive) tolerance *= 0.1; else steps *= 2;
+        }
+}
+
+void reference(const TestProblem& p)
+{
+        std::vector<double> y = IVP::BulirschStoer(1000000,1.e-14).solve(p.f,p.t_ini,p.y_ini,p.t_end);
+        std::cout<<p.name<<": {"<<std::setprecision(17);
+        for (std::size_t i = 0; i<y.size(); ++i) std::cout<<(i?", ":" ")<<y[i];
+        std::cout<<" }"<<std::endl;
+}
+
+int main(int argc, char** argv)
+{
+        std::vector<std::string> names(argv + 1, argv + argc);
+        bool references = (!names.empty()) && (names.front() == "--reference");
+        if (references) names.erase(names.begin());
+        auto selected = [&names] (const std::string& name, const std::vector<std::string>& all)
+        {
+                bool any = std::any_of(names.begin(),names.end(),[&all] (const std::string& n) { return std::find(all.begin(),all.end(),n) != all.end(); });
+                return (!any) || (std::find(names.begin(),names.end(),name) != names.end());
+        };
+        std::vector<std::string> problems;
+        for (const TestProblem& p : test_problems()) problems.push_back(p.name);
+
+        if (references)
+        {
+                for (const TestProblem& p : test_problems()) if (selected(p.name,problems)) reference(p);
+                return 0;
+        }
+        std::cout<<"problem,method,steps,tolerance,error,seconds,evaluations"<<std::endl;
+        for (const TestProblem& p : test_problems()) if (selected(p.name,problems))
+                for (const std::string& method : IVP::any_solver_methods()) if (selected(method,IVP::any_solver_methods()))
+                        sweep(p,method);
+}
@@ -2,6 +2,8 @@
 #define _IVP_ADAPTIVE_H_
 
 #include "method.h"
+#include "thread-pool.h"
+#include <memory>
 //#include <iostream>
 
 namespace IVP {
@@ -14,16 +16,13 @@ public:
 
 private:
 	template<typename T>
-	auto estimate_error_vector(const T& e1, const T& e2) const -> typename std::remove_reference<decltype(*(e1.begin()))>::type
+	auto estimate_error_vector(const T& e1, const T& e2) const -> typename state_traits<T>::value_type
 	{
-//		typename std::remove_const<typename std::remove_reference<decltype(*(e1.begin()))>::type>::type sol 
-//										= decltype(*(e1.begin()))(0.0);
-		auto sol = decltype(*(e1.begin()))(0.0);
-		auto i1 = e1.begin();
-		auto i2 = e2.begin();
-		for(; (i1 != e1.end()) && (i2!=e2.end());i1++, i2++)
+		typename state_traits<T>::value_type sol(0.0);
+		std::size_t n = std::min(state_traits<T>::size(e1),state_traits<T>::size(e2));
+		for (std::size_t i = 0; i<n; ++i)
 		{
-			auto err = estimate_error(*i1, *i2);
+			auto err = estimate_error(state_traits<T>::at(e1,i), state_traits<T>::at(e2,i));
 			if (err>sol) sol = err;
 		} 
 		return sol;
@@ -62,24 +61,34 @@ template<typename BaseMethod, typename Estimator = ErrorEstimator, typename Adap
 	bool embedded = BaseMethod::is_embedded> 
 class Adaptive : public Method<Adaptive<BaseMethod,Estimator,AdaptationStrategy,embedded> >
 {
-	float _tolerance; float min_step;
+	double _tolerance; double min_step;
 	BaseMethod _base_method;
 	Estimator estimator;
 	AdaptationStrategy adaptation;
+	std::shared_ptr<SpinningWorker> worker;
 public:
-	Adaptive(unsigned int ns = 1, float tol = 1.e-5, float _min_step = 0.0) :
+	Adaptive(unsigned int ns = 1, double tol = 1.e-5, double _min_step = 0.0) :
 		Method<Adaptive<BaseMethod,Estimator,AdaptationStrategy> >(ns), _tolerance(tol), min_step(_min_step) { }
-	Adaptive(const BaseMethod& bm, unsigned int ns = 1, float tol = 1.e-5, float _min_step = 0.0) :
+	Adaptive(const BaseMethod& bm, unsigned int ns = 1, double tol = 1.e-5, double _min_step = 0.0) :
 		Method<Adaptive<BaseMethod,Estimator,AdaptationStrategy> >(ns), _tolerance(tol), min_step(_min_step), _base_method(bm) { }
-	Adaptive(const BaseMethod& bm, const Estimator& _estimator, unsigned int ns = 1, float tol = 1.e-5, float _min_step = 0.0) :
+	Adaptive(const BaseMethod& bm, const Estimator& _estimator, unsigned int ns = 1, double tol = 1.e-5, double _min_step = 0.0) :
 		Method<Adaptive<BaseMethod,Estimator,AdaptationStrategy> >(ns), _tolerance(tol), min_step(_min_step), _base_method(bm), estimator(_estimator) { }
 	Adaptive(const BaseMethod& bm, const Estimator& _estimator, const AdaptationStrategy& _adaptation, 
-		 unsigned int ns = 1, float tol = 1.e-5, float _min_step = 0.0) :
+		 unsigned int ns = 1, double tol = 1.e-5, double _min_step = 0.0) :
 		Method<Adaptive<BaseMethod,Estimator,AdaptationStrategy> >(ns), _tolerance(tol), min_step(_min_step), _base_method(bm), estimator(_estimator), adaptation(_adaptation) { }
 
 	const BaseMethod& base_method() const { return _base_method; }
-	float tolerance() const { return _tolerance; }
-	void set_tolerance(float t) { _tolerance = t; }
+	double tolerance() const { return _tolerance; }
+	void set_tolerance(double t) { _tolerance = t; }
+
+	/* \brief Runs the full step on a helper thread while this one takes the two half steps (opt-in).
+	 *
+	 * Worth it when f is expensive: the wall clock cost of a step goes from about 3 to 2 base steps. f and the
+	 * base method are then used from two threads at once. Copies of this method share the helper thread, so they
+	 * must not step at the same time.
+	 */
+	void set_parallel(bool p) { worker = p?std::make_shared<SpinningWorker>():nullptr; }
+	bool parallel() const { return bool(worker); }
 
 	/* \brief Indicates which information is passed between steps (apart from the standard one).
          *
@@ -100,12 +109,28 @@ public:
 			YType s2 = y_t;
 			real full_step = ht;
 			real half_step = 0.5*ht;
-			base_method().next(f,t,s1,full_step);
-			real t1 = base_method().next(f,t,s2,half_step);
-			real t2 = base_method().next(f,t1,s2,half_step);
-			real error = estimator.estimate_error(s1,s2);
+			real t1, t2;  //t2 is that of the full step: t1 + half_step may round to just before t + ht, and never reach t_end
+			real error;
+			{
+				IVP_TRACE_SCOPE(attempt, "attempt", t, ht);
+				auto full = [&] () { t2 = base_method().next(f,t,s1,full_step); };
+				if (worker) worker->post(full); else full();
+				try
+				{
+					t1 = base_method().next(f,t,s2,half_step);
+					base_method().next(f,t1,s2,half_step);
+				}
+				catch (...)
+				{	//The full step still uses f, t and s1: let it finish before they go out of scope
+					if (worker) { try { worker->wait(); } catch (...) { } }
+					throw;
+				}
+				if (worker) worker->wait();
+				error = estimator.estimate_error(s1,s2);
+				IVP_TRACE_RESULT(attempt, error, error<=real(tolerance()));
+			}
 			ht = adaptation.new_step(ht,error,real(tolerance()));
-			if (error>tolerance()) return next(f,t,y_t,ht);
+			if (error>real(tolerance())) return next(f,t,y_t,ht);
 			else {   y_t = s2; return t2; }
 		}
 	}
@@ -116,24 +141,24 @@ template<typename BaseMethod, typename Estimator, typename AdaptationStrategy>
 class Adaptive<BaseMethod, Estimator, AdaptationStrategy, true> :
 	 public Method<Adaptive<BaseMethod,Estimator,AdaptationStrategy,true> >
 {
-	float _tolerance; float min_step;
+	double _tolerance; double min_step;
 	BaseMethod _base_method;
 	Estimator estimator;
 	AdaptationStrategy adaptation;
 public:
-	Adaptive(unsigned int ns = 1, float tol = 1.e-5, float _min_step = 0.0) :
+	Adaptive(unsigned int ns = 1, double tol = 1.e-5, double _min_step = 0.0) :
 		Method<Adaptive<BaseMethod,Estimator,AdaptationStrategy> >(ns), _tolerance(tol), min_step(_min_step) { }
-	Adaptive(const BaseMethod& bm, unsigned int ns = 1, float tol = 1.e-5, float _min_step = 0.0) :
+	Adaptive(const BaseMethod& bm, unsigned int ns = 1, double tol = 1.e-5, double _min_step = 0.0) :
 		Method<Adaptive<BaseMethod,Estimator,AdaptationStrategy> >(ns), _tolerance(tol), min_step(_min_step), _base_method(bm) { }
-	Adaptive(const BaseMethod& bm, const Estimator& _estimator, unsigned int ns = 1, float tol = 1.e-5, float _min_step = 0.0) :
+	Adaptive(const BaseMethod& bm, const Estimator& _estimator, unsigned int ns = 1, double tol = 1.e-5, double _min_step = 0.0) :
 		Method<Adaptive<BaseMethod,Estimator,AdaptationStrategy> >(ns), _tolerance(tol), min_step(_min_step), _base_method(bm), estimator(_estimator) { }
 	Adaptive(const BaseMethod& bm, const Estimator& _estimator, const AdaptationStrategy& _adaptation, 
-		 unsigned int ns = 1, float tol = 1.e-5, float _min_step = 0.0) :
+		 unsigned int ns = 1, double tol = 1.e-5, double _min_step = 0.0) :
 		Method<Adaptive<BaseMethod,Estimator,AdaptationStrategy> >(ns), _tolerance(tol), min_step(_min_step), _base_method(bm), estimator(_estimator), adaptation(_adaptation) { }
 
 	const BaseMethod& base_method() const { return _base_method; }
-	float tolerance() const { return _tolerance; }
-	void set_tolerance(float t) { _tolerance = t; }
+	double tolerance() const { return _tolerance; }
+	void set_tolerance(double t) { _tolerance = t; }
 
 	/* \brief Indicates which information is passed between steps (apart from the standard one).
          *
@@ -152,11 +177,16 @@ public:
 		else
 		{
 			YType s2 = y_t;
-			real t2 = base_method().next_embedded(f,t,s2,ht,s1);
-			real error = estimator.estimate_error(s1,s2);
+			real t2, error;
+			{
+				IVP_TRACE_SCOPE(attempt, "attempt", t, ht);
+				t2 = base_method().next_embedded(f,t,s2,ht,s1);
+				error = estimator.estimate_error(s1,s2);
+				IVP_TRACE_RESULT(attempt, error, error<=real(tolerance()));
+			}
 			ht = adaptation.new_step(ht,error,real(tolerance()));
 //			std::cerr<<t<<" - "<<y_t<<" -> "<<s1<<","<<s2<<" - Err = "<<error<<" | Step = "<<ht<<std::endl;
-			if (error>tolerance()) return next(f,t,y_t,ht);
+			if (error>real(tolerance())) return next(f,t,y_t,ht);
 			else {   y_t = s2; return t2; }
 		}
 	}
@@ -169,12 +199,18 @@ public:
 		else
 		{
 			YType s2 = y_t;
-			real t2 = base_method().next_embedded(f,t,s2,ht,bs,s1);
-			real error = estimator.estimate_error(s1,s2);
+			BetweenSteps bs2 = bs; //A rejected step must not leave its data (i.e. FSAL evaluations) behind
+			real t2, error;
+			{
+				IVP_TRACE_SCOPE(attempt, "attempt", t, ht);
+				t2 = base_method().next_embedded(f,t,s2,ht,bs2,s1);
+				error = estimator.estimate_error(s1,s2);
+				IVP_TRACE_RESULT(attempt, error, error<=real(tolerance()));
+			}
 			ht = adaptation.new_step(ht,error,real(tolerance()));
 //			std::cerr<<t<<" - "<<y_t<<" -> "<<s1<<","<<s2<<" - Err = "<<error<<" | Step = "<<ht<<std::endl;
-			if (error>tolerance()) return next(f,t,y_t,ht,bs);
-			else {   y_t = s2; return t2; }
+			if (error>real(tolerance())) return next(f,t,y_t,ht,bs);
+			else {   y_t = s2; bs = std::move(bs2); return t2; }
 		}
 	}
 
@@ -0,0 +1,175 @@
+#ifndef _IVP_ADDITIVE_RUNGE_KUTTA_H_
+#define _IVP_ADDITIVE_RUNGE_KUTTA_H_
+
+#include "method.h"
+#include "problem.h"
+#include "dense.h"
+#include "state.h"
+#include <array>
+#include <vector>
+#include <type_traits>
+
+namespace IVP
+{
+
+/* \brief Solves (1 - a*c1)*x = r, the implicit equation of a stage when only the linear part is implicit.
+ *
+ * For scalar c1 it is a division. Matrices need a specialization (see the one for DenseMatrix).
+ */
+template<typename C1>
+class ShiftedLinearSolver
+{
+public:
+	template<typename real, typename YType>
+	YType solve(const C1& c1, const real& a, const YType& r) { return r/(real(1) - a*c1); }
+};
+
+/* The factorization of 1 - a*c1 is kept, and only redone when a or c1 change: with constant coefficients and
+ * a constant step size (or between step size changes under Adaptive) every stage reuses it.
+ */
+template<typename T>
+class ShiftedLinearSolver<DenseMatrix<T>>
+{
+	DenseLU<T> lu;
+	DenseMatrix<T> c1_factored;
+	double a_factored;
+	bool valid;
+	std::vector<T> b;
+public:
+	ShiftedLinearSolver() : a_factored(0.0), valid(false) { }
+
+	template<typename real, typename YType>
+	YType solve(const DenseMatrix<T>& c1, const real& a, const YType& r)
+	{
+		std::size_t n = c1.rows();
+		if (!valid || (double(a) != a_factored) || (c1 != c1_factored))
+		{
+			DenseMatrix<T> m(n,n);
+			for (std::size_t i = 0; i<n; ++i)
+			{
+				for (std::size_t j = 0; j<n; ++j) m(i,j) = -T(a)*c1(i,j);
+				m(i,i) += T(1);
+			}
+			lu.factor(m);
+			c1_factored = c1; a_factored = double(a); valid = true;
+		}
+		b.resize(n);
+		for (std::size_t i = 0; i<n; ++i) b[i] = state_traits<YType>::at(r,i);
+		lu.solve(b);
+		YType x = r;
+		for (std::size_t i = 0; i<n; ++i) state_traits<YType>::at(x,i) = b[i];
+		return x;
+	}
+};
+
+/* \brief ARK3(2)4L[2]SA of Kennedy and Carpenter (2003): third order with a second order embedded solution,
+ * four stages (three implicit solves), L-stable and stiffly accurate implicit part.
+ */
+struct ARK324L2SATableau
+{
+	static constexpr std::size_t stages = 4;
+	static constexpr double gamma = 1767732205903.0/4055673282236.0;
+	static constexpr double c[stages] = { 0.0, 1767732205903.0/2027836641118.0, 3.0/5.0, 1.0 };
+	static constexpr double ae[stages][stages] = {
+		{ 0.0, 0.0, 0.0, 0.0 },
+		{ 1767732205903.0/2027836641118.0, 0.0, 0.0, 0.0 },
+		{ 5535828885825.0/10492691773637.0, 788022342437.0/10882634858940.0, 0.0, 0.0 },
+		{ 6485989280629.0/16251701735622.0, -4246266847089.0/9704473918619.0, 10755448449292.0/10357097424841.0, 0.0 } };
+	static constexpr double ai[stages][stages] = {
+		{ 0.0, 0.0, 0.0, 0.0 },
+		{ 1767732205903.0/4055673282236.0, gamma, 0.0, 0.0 },
+		{ 2746238789719.0/10658868560708.0, -640167445237.0/6845629431997.0, gamma, 0.0 },
+		{ 1471266399579.0/7840856788654.0, -4482444167858.0/7529755066697.0, 11266239266428.0/11593286722821.0, gamma } };
+	static constexpr double b[stages] =
+		{ 1471266399579.0/7840856788654.0, -4482444167858.0/7529755066697.0, 11266239266428.0/11593286722821.0, gamma };
+	static constexpr double b_embedded[stages] =
+		{ 2756255671327.0/12835298489170.0, -10771552573575.0/22201958757719.0, 9247589265047.0/10645013368117.0, 2193209047091.0/5459859503100.0 };
+};
+
+/* \brief ARK4(3)6L[2]SA of Kennedy and Carpenter (2003): fourth order with a third order embedded solution,
+ * six stages (five implicit solves), L-stable and stiffly accurate implicit part.
+ */
+struct ARK436L2SATableau
+{
+	static constexpr std::size_t stages = 6;
+	static constexpr double gamma = 1.0/4.0;
+	static constexpr double c[stages] = { 0.0, 1.0/2.0, 83.0/250.0, 31.0/50.0, 17.0/20.0, 1.0 };
+	static constexpr double ae[stages][stages] = {
+		{ 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 },
+		{ 1.0/2.0, 0.0, 0.0, 0.0, 0.0, 0.0 },
+		{ 13861.0/62500.0, 6889.0/62500.0, 0.0, 0.0, 0.0, 0.0 },
+		{ -116923316275.0/2393684061468.0, -2731218467317.0/15368042101831.0, 9408046702089.0/11113171139209.0, 0.0, 0.0, 0.0 },
+		{ -451086348788.0/2902428689909.0, -2682348792572.0/7519795681897.0, 12662868775082.0/11960479115383.0,
+		  3355817975965.0/11060851509271.0, 0.0, 0.0 },
+		{ 647845179188.0/3216320057751.0, 73281519250.0/8382639484533.0, 552539513391.0/3454668386233.0,
+		  3354512671639.0/8306763924573.0, 4040.0/17871.0, 0.0 } };
+	static constexpr double ai[stages][stages] = {
+		{ 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 },
+		{ 1.0/4.0, gamma, 0.0, 0.0, 0.0, 0.0 },
+		{ 8611.0/62500.0, -1743.0/31250.0, gamma, 0.0, 0.0, 0.0 },
+		{ 5012029.0/34652500.0, -654441.0/2922500.0, 174375.0/388108.0, gamma, 0.0, 0.0 },
+		{ 15267082809.0/155376265600.0, -71443401.0/120774400.0, 730878875.0/902184768.0, 2285395.0/8070912.0, gamma, 0.0 },
+		{ 82889.0/524892.0, 0.0, 15625.0/83664.0, 69875.0/102672.0, -2260.0/8211.0, gamma } };
+	static constexpr double b[stages] =
+		{ 82889.0/524892.0, 0.0, 15625.0/83664.0, 69875.0/102672.0, -2260.0/8211.0, gamma };
+	static constexpr double b_embedded[stages] =
+		{ 4586570599.0/29645900160.0, 0.0, 178811875.0/945068544.0, 814220225.0/1159782912.0, -3700637.0/11593932.0, 61727.0/225920.0 };
+};
+
+/**
+ * Implicit-explicit additive Runge-Kutta method over an AdditiveProblem y' = c1(t)*y + c0(t) + n(t,y). Both
+ * tableaux share c and b; the implicit one is singly diagonally implicit with an explicit first stage (ESDIRK).
+ * Stage i solves
+ *     (1 - h*gamma*c1(t_i))*Y_i = y + h*sum_{j<i} (ae_ij*n(t_j,Y_j) + ai_ij*(c1(t_j)*Y_j + c0(t_j))) + h*gamma*c0(t_i)
+ * so the step size is limited by the accuracy of the nonlinear part, not by the stiffness of c1. The linear part
+ * of each stage is recovered from its solve instead of multiplying by c1 again. The factorization of the shifted
+ * matrix is kept between steps (see ShiftedLinearSolver), so with constant c1 it only happens when h changes.
+ * The embedded solution uses b_embedded, for Adaptive.
+ */
+template<typename Tableau>
+class AdditiveRungeKutta : public MethodEmbedded<AdditiveRungeKutta<Tableau>>
+{
+	static constexpr std::size_t S = Tableau::stages;
+public:
+	AdditiveRungeKutta(double initial_step) : MethodEmbedded<AdditiveRungeKutta<Tableau>>(initial_step) { }
+	AdditiveRungeKutta(unsigned int ns = 1) : MethodEmbedded<AdditiveRungeKutta<Tableau>>(ns) { }
+	AdditiveRungeKutta(int ns) : MethodEmbedded<AdditiveRungeKutta<Tableau>>((unsigned int)ns) { }
+
+	template<typename YType, typename F1, typename F0, typename N, typename real>
+	ShiftedLinearSolver<typename std::decay<decltype(std::declval<const F1&>()(std::declval<real>()))>::type>
+		between_steps_first(const AdditiveProblem<F1,F0,N>& f, const real& t_ini, const YType& y_ini, const real& t_end) const
+	{	return ShiftedLinearSolver<typename std::decay<decltype(f.c1(t_ini))>::type>(); }
+
+	template<typename YType, typename F1, typename F0, typename N, typename real, typename Solver>
+	real next_embedded(const AdditiveProblem<F1,F0,N>& f, real t, YType& y_t, real& h, Solver& solver, YType& other) const
+	{
+		std::array<YType,S> fe, fi;  //Explicit (nonlinear) and implicit (linear) evaluations of each stage
+		real hg = h*real(Tableau::gamma);
+		fe[0] = f.n(t,y_t);
+		fi[0] = f.c1(t)*y_t + f.c0(t);
+		for (std::size_t i = 1; i<S; ++i)
+		{
+			real ti = t + real(Tableau::c[i])*h;
+			YType r = y_t;
+			for (std::size_t j = 0; j<i; ++j)
+				linear_combination_inplace(r, {double(h)*Tableau::ae[i][j], double(h)*Tableau::ai[i][j]}, fe[j], fi[j]);
+			YType yi = solver.solve(f.c1(ti), hg, r + hg*f.c0(ti));
+			fi[i] = (yi - r)/hg;
+			fe[i] = f.n(ti,yi);
+		}
+		other = y_t;
+		for (std::size_t j = 0; j<S; ++j)
+		{
+			linear_combination_inplace(other, {double(h)*Tableau::b_embedded[j], double(h)*Tableau::b_embedded[j]}, fe[j], fi[j]);
+			linear_combination_inplace(y_t, {double(h)*Tableau::b[j], double(h)*Tableau::b[j]}, fe[j], fi[j]);
+		}
+		return t+h;
+	}
+};
+
+using ARK324L2SA = AdditiveRungeKutta<ARK324L2SATableau>;
+using ARK436L2SA = AdditiveRungeKutta<ARK436L2SATableau>;
+
+}; //namespace IVP
+
+#endif
@@ -0,0 +1,261 @@
+#ifndef _IVP_ADJOINT_H_
+#define _IVP_ADJOINT_H_
+
+#include "method.h"
+#include "state.h"
+#include <algorithm>
+#include <type_traits>
+
+namespace IVP {
+
+/* \brief Advances y by k steps of size h of method m, starting at step i of a uniform grid over t_ini.
+ *
+ * The data between steps (i.e. FSAL evaluations) is seeded at the first of the k steps and kept along them.
+ */
+template<typename M, typename YType, typename Function, typename real,
+	typename BetweenSteps = typename Type<M,YType,Function,real>::BetweenSteps>
+struct FixedStepper
+{
+	static void advance(const M& m, const Function& f, const real& t_ini, const real& h, std::size_t i, std::size_t k, YType& y)
+	{
+		real t = t_ini + real(i)*h;
+		BetweenSteps bs = wrapped_between_steps_first(m,f,t,y,t + real(k)*h);
+		for (std::size_t j = 0; j<k; ++j)
+		{
+			real ht = h;
+			m.next(f,t_ini + real(i+j)*h,y,ht,bs);
+		}
+	}
+};
+
+template<typename M, typename YType, typename Function, typename real>
+struct FixedStepper<M,YType,Function,real,void>
+{
+	static void advance(const M& m, const Function& f, const real& t_ini, const real& h, std::size_t i, std::size_t k, YType& y)
+	{
+		for (std::size_t j = 0; j<k; ++j)
+		{
+			real ht = h;
+			m.next(f,t_ini + real(i+j)*h,y,ht);
+		}
+	}
+};
+
+/* \brief State of the backward sweep: the forward state y, the adjoint lambda and the gradient accumulator mu.
+ */
+template<typename YType, typename PType>
+class AdjointState
+{
+public:
+	YType y, lambda; PType mu;
+
+	AdjointState() { }
+	AdjointState(const YType& _y, const YType& _lambda, const PType& _mu) : y(_y), lambda(_lambda), mu(_mu) { }
+
+	friend AdjointState operator+(const AdjointState& a, const AdjointState& b)
+	{	return AdjointState(a.y + b.y, a.lambda + b.lambda, a.mu + b.mu); }
+	friend AdjointState operator-(const AdjointState& a, const AdjointState& b)
+	{	return AdjointState(a.y - b.y, a.lambda - b.lambda, a.mu - b.mu); }
+	friend AdjointState operator-(const AdjointState& a)
+	{	return AdjointState(-a.y, -a.lambda, -a.mu); }
+
+	template<typename S, typename = typename std::enable_if<std::is_arithmetic<S>::value>::type>
+	friend AdjointState operator*(const S& k, const AdjointState& a)
+	{	return AdjointState(k*a.y, k*a.lambda, k*a.mu); }
+	template<typename S, typename = typename std::enable_if<std::is_arithmetic<S>::value>::type>
+	friend AdjointState operator*(const AdjointState& a, const S& k)
+	{	return k*a; }
+	template<typename S, typename = typename std::enable_if<std::is_arithmetic<S>::value>::type>
+	friend AdjointState operator/(const AdjointState& a, const S& k)
+	{	return AdjointState(a.y/k, a.lambda/k, a.mu/k); }
+};
+
+/* Elements are y, then lambda, then mu. Combinations are done blockwise. */
+template<typename YType, typename PType>
+struct state_traits<AdjointState<YType,PType>>
+{
+	using value_type = typename state_traits<YType>::value_type;
+
+	static std::size_t size(const AdjointState<YType,PType>& v)
+	{	return 2*state_traits<YType>::size(v.y) + state_traits<PType>::size(v.mu); }
+	static value_type at(const AdjointState<YType,PType>& v, std::size_t i)
+	{
+		std::size_t n = state_traits<YType>::size(v.y);
+		if (i<n) return state_traits<YType>::at(v.y,i);
+		else if (i<2*n) return state_traits<YType>::at(v.lambda,i-n);
+		else return value_type(state_traits<PType>::at(v.mu,i-2*n));
+	}
+
+	static value_type norm(const AdjointState<YType,PType>& v)
+	{	return std::max({ state_traits<YType>::norm(v.y), state_traits<YType>::norm(v.lambda), value_type(state_traits<PType>::norm(v.mu)) }); }
+
+	template<std::size_t N, typename... K>
+	static AdjointState<YType,PType> linear_combination(const AdjointState<YType,PType>& y, const double (&c)[N], const K&... k)
+	{
+		return AdjointState<YType,PType>(state_traits<YType>::linear_combination(y.y,c,k.y...),
+			state_traits<YType>::linear_combination(y.lambda,c,k.lambda...), state_traits<PType>::linear_combination(y.mu,c,k.mu...));
+	}
+
+	template<std::size_t N, typename... K>
+	static void linear_combination_inplace(AdjointState<YType,PType>& y, const double (&c)[N], const K&... k)
+	{
+		state_traits<YType>::linear_combination_inplace(y.y,c,k.y...);
+		state_traits<YType>::linear_combination_inplace(y.lambda,c,k.lambda...);
+		state_traits<PType>::linear_combination_inplace(y.mu,c,k.mu...);
+	}
+};
+
+/* \brief Adjoint equations of y' = f(t,y,p) for a loss L(y(t_end)), integrated from t_end back to t_ini:
+ *     y'      = f(t,y)
+ *     lambda' = -df/dy(t,y)^T lambda
+ *     mu'     = -df/dp(t,y)^T lambda
+ * with lambda(t_end) = dL/dy and mu(t_end) = 0, so that lambda(t_ini) = dL/dy_ini and mu(t_ini) = dL/dp.
+ *
+ * vjp_y(t,y,lambda) and vjp_p(t,y,lambda) are the vector-Jacobian products above. y is only integrated
+ * backwards over a single step, from an exact forward state, so this is stable also for dissipative problems.
+ */
+template<typename Function, typename VjpY, typename VjpP>
+class AdjointProblem
+{
+public:
+	Function f; VjpY vjp_y; VjpP vjp_p;
+	AdjointProblem(const Function& _f, const VjpY& _vjp_y, const VjpP& _vjp_p) : f(_f), vjp_y(_vjp_y), vjp_p(_vjp_p) { }
+
+	template<typename real, typename YType, typename PType>
+	AdjointState<YType,PType> operator()(const real& t, const AdjointState<YType,PType>& x) const
+	{	return AdjointState<YType,PType>(f(t,x.y), -vjp_y(t,x.y,x.lambda), -vjp_p(t,x.y,x.lambda)); }
+};
+
+template<typename YType, typename PType>
+struct AdjointSolution
+{
+	YType y;          //y(t_end)
+	YType lambda;     //dL/dy_ini
+	PType gradient;   //dL/dp
+	std::size_t forward_steps, backward_steps;
+	unsigned int peak_snapshots;
+};
+
+/* \brief Gradient of a loss at the end of the integration through the adjoint equations, with binomial
+ *        (Revolve-like) checkpointing of the forward states.
+ *
+ * The forward solve uses a uniform grid of steps of Method, so Method must be a fixed step method (adaptive
+ * ones would change the step on replay). Only a given number of forward states (snapshots) are kept at
+ * once; the rest are recomputed from the closest snapshot when the backward sweep needs them. With s
+ * snapshots and N steps each step is recomputed at most t times, with t the smallest integer such that
+ * binomial(s + t, s) >= N, so a handful of snapshots (~log N) already keep the cost to a few forward solves.
+ * With no snapshots the recomputation is quadratic.
+ */
+template<typename M>
+class Adjoint
+{
+	M _method;
+	std::size_t _steps;
+	unsigned int _snapshots;
+
+	//binomial(s + t, s), saturated
+	static std::size_t beta(unsigned int s, std::size_t t)
+	{
+		double sol = 1.0;
+		for (unsigned int k = 1; k<=s; ++k) sol *= double(t + k)/double(k);
+		return (sol > 1.e18)?std::size_t(1.e18):std::size_t(sol + 0.5);
+	}
+
+	static std::size_t repetitions(std::size_t n, unsigned int s)
+	{	std::size_t t = 1; while (beta(s,t) < n) ++t; return t; }
+
+	template<typename Function, typename Problem, typename Loss, typename YType, typename PType, typename real>
+	struct Sweep
+	{
+		const M& m; const Function& f; const Problem& problem; const Loss& loss;
+		real t_ini, h;
+		AdjointState<YType,PType> x;
+		bool started;
+		AdjointSolution<YType,PType> solution;
+		unsigned int live_snapshots;
+
+		void advance(YType& y, std::size_t i, std::size_t k)
+		{
+			FixedStepper<M,YType,Function,real>::advance(m,f,t_ini,h,i,k,y);
+			solution.forward_steps += k;
+		}
+
+		//Takes lambda and mu from t_ini + (i+1)*h back to t_ini + i*h, given y there
+		void backward(std::size_t i, const YType& y_next)
+		{
+			if (!started)
+			{
+				solution.y = y_next;
+				x.lambda = loss(y_next); x.mu = real(0)*problem.vjp_p(t_ini + real(i+1)*h,y_next,x.lambda);
+				started = true;
+			}
+			x.y = y_next;
+			FixedStepper<M,AdjointState<YType,PType>,Problem,real>::advance(m,problem,t_ini + real(i+1)*h,-h,0,1,x);
+			solution.backward_steps++;
+		}
+	};
+
+	template<typename S, typename YType>
+	void reverse(S& sweep, std::size_t i, const YType& y_i, std::size_t n, unsigned int s) const
+	{
+		if (n == 1)
+		{
+			YType y_next = y_i; sweep.advance(y_next,i,1);
+			sweep.backward(i,y_next);
+		}
+		else if (s == 0)
+		{
+			for (std::size_t j = n; j-->0; )
+			{
+				YType y = y_i; sweep.advance(y,i,j+1);
+				sweep.backward(i+j,y);
+			}
+		}
+		else
+		{
+			std::size_t right = std::min(beta(s-1,repetitions(n,s)),n-1);
+			{
+				YType y_m = y_i; sweep.advance(y_m,i,n-right);
+				sweep.solution.peak_snapshots = std::max(sweep.solution.peak_snapshots,++sweep.live_snapshots);
+				reverse(sweep,i+n-right,y_m,right,s-1);
+				--sweep.live_snapshots;
+			}
+			reverse(sweep,i,y_i,n-right,s);
+		}
+	}
+
+public:
+	Adjoint(const M& m, std::size_t steps, unsigned int snapshots = 8) : _method(m), _steps(steps), _snapshots(snapshots) { }
+
+	const M& method()             const { return _method; }
+	std::size_t steps()           const { return _steps; }
+	unsigned int snapshots()      const { return _snapshots; }
+	void set_snapshots(unsigned int s)  { _snapshots = s; }
+
+	/* loss(y_end) returns dL/dy at y(t_end) */
+	template<typename Function, typename VjpY, typename VjpP, typename Loss, typename YType, typename real>
+	auto gradient(const Function& f, const VjpY& vjp_y, const VjpP& vjp_p, const real& t_ini, const YType& y_ini,
+		const real& t_end, const Loss& loss) const
+		-> AdjointSolution<YType,typename std::decay<decltype(vjp_p(t_ini,y_ini,y_ini))>::type>
+	{
+		using PType = typename std::decay<decltype(vjp_p(t_ini,y_ini,y_ini))>::type;
+		using Problem = AdjointProblem<Function,VjpY,VjpP>;
+		Problem problem(f,vjp_y,vjp_p);
+		Sweep<Function,Problem,Loss,YType,PType,real> sweep{method(),f,problem,loss,t_ini,(t_end - t_ini)/real(steps()),
+			AdjointState<YType,PType>(),false,AdjointSolution<YType,PType>(),0};
+		sweep.solution.forward_steps = sweep.solution.backward_steps = 0; sweep.solution.peak_snapshots = 0;
+
+		reverse(sweep,0,y_ini,steps(),snapshots());
+
+		sweep.solution.lambda = sweep.x.lambda;
+		sweep.solution.gradient = sweep.x.mu;
+		return sweep.solution;
+	}
+};
+
+template<typename M>
+Adjoint<M> adjoint(const M& m, std::size_t steps, unsigned int snapshots = 8) { return Adjoint<M>(m,steps,snapshots); }
+
+}; //namespace IVP
+
+#endif
@@ -0,0 +1,128 @@
+#ifndef _IVP_ANY_SOLVER_H_
+#define _IVP_ANY_SOLVER_H_
+
+#include "method.h"
+#include "euler.h"
+#include "runge-kutta-2.h"
+#include "runge-kutta-4.h"
+#include "backward-euler.h"
+#include "euler-trapezoidal.h"
+#include "implicit-solver.h"
+#include "adaptive.h"
+#include "embedded-runge-kutta-2.h"
+#include "bogacki-shampine.h"
+#include "dopri.h"
+#include "bulirsch-stoer.h"
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+namespace IVP {
+
+/* \brief Any method, chosen at runtime, for a fixed YType and Function.
+ *
+ * The method is hidden behind a single virtual call per solve (or per call of the step callback), so the stages
+ * are still compiled for the actual method and function, inlined as usual. By default the function is a
+ * std::function, which costs an indirect call per evaluation of f; for the cheapest f use the actual type of the
+ * function as Function instead (but then it is instantiated in the program, not taken from the library).
+ *
+ * Copies share the method, which is immutable.
+ */
+template<typename YType, typename Function = std::function<YType(double,const YType&)>, typename real = double>
+class AnySolver
+{
+public:
+	using Callback = std::function<void(const real&, const YType&)>;
+
+private:
+	struct Concept
+	{
+		virtual ~Concept() { }
+		virtual YType solve(const Function& f, const real& t_ini, const YType& y_ini, const real& t_end) const = 0;
+		virtual std::size_t steps(const Function& f, const real& t_ini, const YType& y_ini, const real& t_end, const Callback& callback) const = 0;
+	};
+
+	template<typename M>
+	struct Model : public Concept
+	{
+		M m;
+		Model(const M& _m) : m(_m) { }
+
+		YType solve(const Function& f, const real& t_ini, const YType& y_ini, const real& t_end) const override
+		{	return m.solve(f,t_ini,y_ini,t_end); }
+
+		std::size_t steps(const Function& f, const real& t_ini, const YType& y_ini, const real& t_end, const Callback& callback) const override
+		{
+			std::size_t n = 0;
+			for (const auto& s : m.steps(f,t_ini,y_ini,t_end)) { callback(s.t(),s.y()); ++n; }
+			return n;
+		}
+	};
+
+	std::shared_ptr<const Concept> method;
+	std::string _name;
+
+public:
+	template<typename M>
+	AnySolver(const M& m, const std::string& name = "") : method(std::make_shared<Model<M>>(m)), _name(name) { }
+
+	const std::string& name() const { return _name; }
+
+	YType solve(const Function& f, const real& t_ini, const YType& y_ini, const real& t_end) const
+	{	return method->solve(f,t_ini,y_ini,t_end); }
+
+	/* Calls callback(t,y) for every step, the initial state included, and returns how many there were */
+	std::size_t steps(const Function& f, const real& t_ini, const YType& y_ini, const real& t_end, const Callback& callback) const
+	{	return method->steps(f,t_ini,y_ini,t_end,callback); }
+};
+
+/* Names of the methods that any_solver knows about */
+inline const std::vector<std::string>& any_solver_methods()
+{
+	static const std::vector<std::string> names{ "euler", "runge-kutta-2", "runge-kutta-4", "backward-euler",
+		"backward-euler-newton", "euler-trapezoidal", "adaptive-runge-kutta-4", "adaptive-embedded-runge-kutta-2",
+		"adaptive-bogacki-shampine", "adaptive-dopri", "bulirsch-stoer" };
+	return names;
+}
+
+/* \brief The method with the given name (see any_solver_methods), from a configuration file or the command line.
+ *
+ * Fixed step methods take steps steps. Adaptive ones take steps as the initial guess and control the error with
+ * tolerance, as do the implicit ones for their iterations. Throws std::invalid_argument for unknown names.
+ */
+template<typename YType, typename Function = std::function<YType(double,const YType&)>, typename real = double>
+AnySolver<YType,Function,real> any_solver(const std::string& method, unsigned int steps = 1, double tolerance = 1.e-5)
+{
+	using Solver = AnySolver<YType,Function,real>;
+	if (method == "euler")                           return Solver(Euler(steps),method);
+	if (method == "runge-kutta-2")                   return Solver(RungeKutta2(steps),method);
+	if (method == "runge-kutta-4")                   return Solver(RungeKutta4(steps),method);
+	if (method == "backward-euler")                  return Solver(BackwardEuler(steps,tolerance),method);
+	if (method == "backward-euler-newton")
+		return Solver(BackwardEulerWith<NewtonIteration<FiniteDifferenceJacobian>>(steps,tolerance),method);
+	if (method == "euler-trapezoidal")               return Solver(EulerTrapezoidal(steps,tolerance),method);
+	if (method == "adaptive-runge-kutta-4")          return Solver(Adaptive<RungeKutta4>(steps,tolerance),method);
+	if (method == "adaptive-embedded-runge-kutta-2") return Solver(Adaptive<EmbeddedRungeKutta2>(steps,tolerance),method);
+	if (method == "adaptive-bogacki-shampine")       return Solver(Adaptive<BogackiShampine>(steps,tolerance),method);
+	if (method == "adaptive-dopri")                  return Solver(Adaptive<Dopri>(steps,tolerance),method);
+	if (method == "bulirsch-stoer")                  return Solver(BulirschStoer(steps,tolerance),method);
+	throw std::invalid_argument("Unknown method: " + method);
+}
+
+/* With the ivp-any-solver library (which defines IVP_ANY_SOLVER_LIBRARY for its users) the factory for the
+ * usual states is compiled once there, instead of in every program that uses it.
+ */
+#ifdef IVP_ANY_SOLVER_LIBRARY
+extern template class AnySolver<float>;
+extern template class AnySolver<double>;
+extern template class AnySolver<std::vector<double>>;
+extern template AnySolver<float> any_solver<float>(const std::string&, unsigned int, double);
+extern template AnySolver<double> any_solver<double>(const std::string&, unsigned int, double);
+extern template AnySolver<std::vector<double>> any_solver<std::vector<double>>(const std::string&, unsigned int, double);
+#endif
+
+}; //namespace IVP
+
+#endif
@@ -0,0 +1,155 @@
+#ifndef _IVP_ASYNC_H_
+#define _IVP_ASYNC_H_
+
+#include "method.h"
+#include <atomic>
+#include <thread>
+#include <memory>
+#include <vector>
+#include <exception>
+
+namespace IVP {
+
+/* \brief Bounded lock-free single producer / single consumer queue.
+ *
+ * Both ends spin for a while and then yield when the queue is full (backpressure on the producer) or empty.
+ */
+template<typename T>
+class SpscRing
+{
+	std::vector<T> slots;
+	std::size_t mask;
+	alignas(64) std::atomic<std::size_t> head; //Next to read, only written by the consumer
+	alignas(64) std::atomic<std::size_t> tail; //Next to write, only written by the producer
+	alignas(64) std::atomic<bool> _closed;
+	std::atomic<bool> _cancelled;
+
+	static std::size_t power_of_two(std::size_t n) { std::size_t p = 1; while (p<n) p<<=1; return p; }
+
+	static void backoff(unsigned int& spins)
+	{
+		if (++spins < 64) return;
+		std::this_thread::yield();
+	}
+public:
+	SpscRing(std::size_t capacity) : slots(power_of_two(capacity)), mask(slots.size()-1),
+		head(0), tail(0), _closed(false), _cancelled(false) { }
+
+	std::size_t capacity() const { return slots.size(); }
+
+	bool try_push(const T& t)
+	{
+		std::size_t tl = tail.load(std::memory_order_relaxed);
+		if (tl - head.load(std::memory_order_acquire) >= slots.size()) return false;
+		slots[tl & mask] = t;
+		tail.store(tl+1,std::memory_order_release);
+		return true;
+	}
+
+	bool try_pop(T& t)
+	{
+		std::size_t hd = head.load(std::memory_order_relaxed);
+		if (hd == tail.load(std::memory_order_acquire)) return false;
+		t = std::move(slots[hd & mask]);
+		head.store(hd+1,std::memory_order_release);
+		return true;
+	}
+
+	/* Waits while full. Returns false if the consumer is gone. */
+	bool push(const T& t)
+	{
+		unsigned int spins = 0;
+		while (!try_push(t))
+		{
+			if (_cancelled.load(std::memory_order_relaxed)) return false;
+			backoff(spins);
+		}
+		return true;
+	}
+
+	/* Waits while empty. Returns false once the producer has closed the queue and everything is read. */
+	bool pop(T& t)
+	{
+		unsigned int spins = 0;
+		while (!try_pop(t))
+		{
+			if (_closed.load(std::memory_order_acquire)) return try_pop(t);
+			backoff(spins);
+		}
+		return true;
+	}
+
+	void close()  { _closed.store(true,std::memory_order_release); }
+	void cancel() { _cancelled.store(true,std::memory_order_relaxed); }
+};
+
+/* \brief Steps of a method computed on a worker thread.
+ *
+ * Iterates like Method::steps, but the integration runs ahead on another thread and publishes each StepData
+ * through a bounded SpscRing, so that whatever the consumer does with the steps (statistics, rendering, writing)
+ * overlaps with the integration itself. When the ring is full the integrator waits for the consumer. If the
+ * method or f throws on the worker, the steps before are still delivered and then the exception is rethrown by
+ * the iteration, on the consumer's thread.
+ */
+template<typename M, typename YType, typename Function, typename real>
+class AsyncSteps
+{
+	using StepData = typename M::template StepData<YType,real>;
+
+	struct State
+	{
+		M m;
+		decltype(std::declval<const M&>().steps(std::declval<const Function&>(),real(),std::declval<const YType&>(),real())) steps;
+		SpscRing<StepData> ring;
+		std::thread worker;
+		std::exception_ptr error; //Thrown by the method or f on the worker, written before the ring is closed
+
+		State(const M& _m, const Function& f, const real& t_ini, const YType& y_ini, const real& t_end, std::size_t capacity) :
+			m(_m), steps(m.steps(f,t_ini,y_ini,t_end)), ring(capacity) { }
+
+		void start()
+		{
+			if (worker.joinable()) return;
+			worker = std::thread([this] () {
+				try { for (const auto& s : steps) if (!ring.push(s)) break; }
+				catch (...) { error = std::current_exception(); }
+				ring.close();
+			});
+		}
+
+		~State() { ring.cancel(); if (worker.joinable()) worker.join(); }
+	};
+
+	std::unique_ptr<State> state;
+public:
+	AsyncSteps(const M& m, const Function& f, const real& t_ini, const YType& y_ini, const real& t_end, std::size_t capacity) :
+		state(new State(m,f,t_ini,y_ini,t_end,capacity)) { }
+
+	class const_iterator : public ConstIteratorFacade<const_iterator>
+	{
+		friend class AsyncSteps;
+		State* state; StepData step_data; bool done;
+		const_iterator(State* _state, bool _done) : state(_state), done(_done) { }
+	public:
+		void inc()
+		{
+			done = !state->ring.pop(step_data);
+			if (done && state->error) { std::exception_ptr e = state->error; state->error = nullptr; std::rethrow_exception(e); }
+		}
+		bool equals(const const_iterator& that) const { return (this->done == that.done); }
+		const StepData& operator*() const { return step_data; }
+	};
+
+	/* Starts the integration. This range can only be iterated once. */
+	const_iterator begin() const { state->start(); const_iterator i(state.get(),false); i.inc(); return i; }
+	const_iterator end()   const { return const_iterator(state.get(),true); }
+};
+
+template<typename M, typename YType, typename Function, typename real>
+AsyncSteps<M,YType,Function,real> async_steps(const M& m, const Function& f, const real& t_ini, const YType& y_ini, const real& t_end,
+	std::size_t capacity = 1024)
+{	return AsyncSteps<M,YType,Function,real>(m,f,t_ini,y_ini,t_end,capacity); }
+
+}; //namespace IVP
+
+#endif
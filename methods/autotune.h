@@ -0,0 +1,173 @@
+#ifndef _IVP_AUTOTUNE_H_
+#define _IVP_AUTOTUNE_H_
+
+#include "any-solver.h"
+#include "state.h"
+#include <map>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <cctype>
+
+namespace IVP {
+
+/* \brief A method with the configuration that was found to be the cheapest for some problem and accuracy. */
+struct TunedSolver
+{
+	std::string method;
+	unsigned int steps;     //Number of steps (fixed step methods) or initial guess (adaptive ones)
+	double tolerance;
+	double error;           //Measured during the calibration, against the reference
+	double seconds;         //Per solve, during the calibration
+
+	bool valid() const { return !method.empty(); }
+
+	template<typename YType, typename Function = std::function<YType(double,const YType&)>, typename real = double>
+	AnySolver<YType,Function,real> solver() const { return any_solver<YType,Function,real>(method,steps,tolerance); }
+};
+
+/**
+ * Chooses, among a set of candidate methods (names for any_solver), the fastest configuration whose error is
+ * below a target:
+ *   - a reference is computed with Bulirsch-Stoer at a tolerance 10^-6 times the target (but not under 10^-14),
+ *   - adaptive methods (names starting with "adaptive-" and "bulirsch-stoer") try tolerances from 10 times the
+ *     target down to 10^-5 times, fixed step methods double their steps from 16 on,
+ *   - a candidate is abandoned as soon as it is slower than the best one found so far (so the default candidates
+ *     start with the ones that are usually fast, to leave little work to the others) or than max_time, or when
+ *     its step size underflows (Bulirsch-Stoer on stiff problems); implicit ones whose iterations do not converge
+ *     go on with smaller steps,
+ * where the error is max |y - reference|/(1 + |reference|) at the end of the calibration interval. Calibrate
+ * over a short but representative interval: the result is meant to be used for longer ones.
+ *
+ * Results are kept by key (the name of the problem and the target) and, if a cache file is given, saved there
+ * after each tuning and loaded on construction, so later runs do not calibrate again.
+ */
+class Autotuner
+{
+	std::string cache_file;
+	std::vector<std::string> candidates;
+	std::map<std::string,TunedSolver> cache;
+	double min_time, max_time;
+
+	static std::string key(const std::string& problem, double target)
+	{
+		std::ostringstream s; s<<problem<<'@'<<target;
+		std::string k = s.str();
+		std::replace_if(k.begin(),k.end(),[] (char c) { return std::isspace((unsigned char)c); },'_');
+		return k;
+	}
+
+	static bool adaptive(const std::string& method)
+	{	return (method.compare(0,9,"adaptive-") == 0) || (method == "bulirsch-stoer"); }
+
+	void load()
+	{
+		std::ifstream in(cache_file);
+		std::string k; TunedSolver t;
+		while (in>>k>>t.method>>t.steps>>t.tolerance>>t.error>>t.seconds) cache[k] = t;
+	}
+
+	void save() const
+	{
+		if (cache_file.empty()) return;
+		std::ofstream out(cache_file);
+		out.precision(17);
+		for (const auto& entry : cache)
+			out<<entry.first<<' '<<entry.second.method<<' '<<entry.second.steps<<' '<<entry.second.tolerance<<' '
+			   <<entry.second.error<<' '<<entry.second.seconds<<'\n';
+	}
+
+	template<typename YType>
+	static double error(const YType& y, const YType& reference)
+	{
+		double sol = 0.0;
+		for (std::size_t i = 0; i<state_traits<YType>::size(y); ++i)
+		{
+			double r = double(state_traits<YType>::at(reference,i));
+			double e = std::abs(double(state_traits<YType>::at(y,i)) - r)/(1.0 + std::abs(r));
+			if (!(e <= sol)) sol = e; //NaN counts as the largest error
+		}
+		return sol;
+	}
+
+	//Average time per solve, repeating it for at least min_time (and at least once)
+	template<typename S, typename Function, typename YType, typename real>
+	double time(const S& solver, const Function& f, const real& t_ini, const YType& y_ini, const real& t_end, YType& y) const
+	{
+		auto start = std::chrono::steady_clock::now();
+		unsigned int n = 0; double elapsed;
+		do
+		{
+			y = solver.solve(f,t_ini,y_ini,t_end); ++n;
+			elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		} while (elapsed < min_time);
+		return elapsed/double(n);
+	}
+
+public:
+	static std::vector<std::string> default_candidates()
+	{
+		return { "adaptive-dopri", "bulirsch-stoer", "adaptive-bogacki-shampine", "adaptive-runge-kutta-4",
+		         "runge-kutta-4", "runge-kutta-2", "adaptive-embedded-runge-kutta-2" };
+	}
+
+	Autotuner(const std::string& _cache_file = "", const std::vector<std::string>& _candidates = default_candidates(),
+		double _min_time = 1.e-3, double _max_time = 0.1) :
+		cache_file(_cache_file), candidates(_candidates), min_time(_min_time), max_time(_max_time)
+	{	if (!cache_file.empty()) load(); }
+
+	/* The tuned configuration, if there is one already */
+	TunedSolver cached(const std::string& problem, double target) const
+	{
+		auto it = cache.find(key(problem,target));
+		return (it == cache.end())?TunedSolver():it->second;
+	}
+
+	/* \brief The fastest configuration with error under target for f from (t_ini,y_ini) to t_end, tuning it if
+	 * needed. The result is invalid (empty method) if no candidate gets there, or if the problem is too stiff for
+	 * the reference.
+	 */
+	template<typename YType, typename Function = std::function<YType(double,const YType&)>, typename real = double>
+	TunedSolver tune(const std::string& problem, const Function& f, const real& t_ini, const YType& y_ini, const real& t_end, double target)
+	{
+		TunedSolver best = cached(problem,target);
+		if (best.valid()) return best;
+
+		YType reference;
+		try { reference = any_solver<YType,Function,real>("bulirsch-stoer",100,std::max(1.e-6*target,1.e-14)).solve(f,t_ini,y_ini,t_end); }
+		catch (const StepSizeUnderflow&) { return best; } //Too stiff to get a reference: nothing can be compared
+		best.seconds = std::numeric_limits<double>::infinity();
+		for (const std::string& method : candidates)
+		{
+			bool adaptive_method = adaptive(method);
+			unsigned int steps = adaptive_method?100:16;
+			double tolerance = adaptive_method?10.0*target:1.e-8;
+			for (unsigned int attempt = 0; attempt < (adaptive_method?7u:17u); ++attempt)
+			{
+				YType y; double seconds;
+				try { seconds = time(any_solver<YType,Function,real>(method,steps,tolerance),f,t_ini,y_ini,t_end,y); }
+				catch (const ImplicitSolverError&) //Steps too large for the implicit solver: try smaller ones
+				{
+					if (adaptive_method) tolerance *= 0.1; else steps *= 2;
+					continue;
+				}
+				catch (const StepSizeUnderflow&) { break; } //Too stiff for the method: tighter tolerances do not help
+				if ((seconds >= best.seconds) || (seconds > max_time)) break; //Refining only makes it slower
+				double e = error(y,reference);
+				if (e <= target) { best = TunedSolver{ method, steps, tolerance, e, seconds }; break; }
+				if (adaptive_method) tolerance *= 0.1; else steps *= 2;
+			}
+		}
+		if (best.valid()) { cache[key(problem,target)] = best; save(); }
+		return best;
+	}
+};
+
+}; //namespace IVP
+
+#endif
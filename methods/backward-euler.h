@@ -2,34 +2,38 @@
 #define _IVP_BACKWARDEULER_H_
 
 #include "method.h"
+#include "implicit-solver.h"
 #include <cmath>
 
 namespace IVP
 {
 
-class BackwardEuler : public Method<BackwardEuler>
+/**
+ * y_{n+1} = y_n + h*f(t_{n+1},y_{n+1}), solved by Solver (see implicit-solver.h). For stiff problems use
+ * NewtonIteration<>, or NewtonKrylovIteration<> when the system is too large for a dense Jacobian.
+ */
+template<typename Solver>
+class BackwardEulerWith : public Method<BackwardEulerWith<Solver>>
 {
-	float tolerance;
+	double tolerance;
+	Solver solver;
 public:
-	BackwardEuler(float s, float tol) :   Method<BackwardEuler>(s),tolerance(tol)  { }
-	BackwardEuler(unsigned int ns = 1, float tol = 1.e-3) : Method<BackwardEuler>(ns),tolerance(tol) { }
+	BackwardEulerWith(double s, double tol, const Solver& _solver = Solver()) :   
+		Method<BackwardEulerWith<Solver>>(s),tolerance(tol),solver(_solver)  { }
+	BackwardEulerWith(unsigned int ns = 1, double tol = 1.e-3, const Solver& _solver = Solver()) : 
+		Method<BackwardEulerWith<Solver>>(ns),tolerance(tol),solver(_solver) { }
 
 	template<typename YType, typename Function, typename real>  
 	real next(const Function& f, const real& t, YType& y_t, const real& ht) const
 	{
-		const unsigned int max_iterations = 10000;
-		unsigned int i = 0;
-		YType y_ti = y_t;
-		YType y_ti1 = y_t+ht*f(t+ht,y_ti);
-		while ((real( norm(y_ti1 - y_ti))>real(tolerance)) && (i<max_iterations))
-		{
-			y_ti = y_ti1; y_ti1 = y_t+ht*f(t+ht,y_ti); i++;
-		}
-		y_t = y_ti1;
+		y_t = solver.solve(f,t+ht,y_t,ht,y_t,tolerance);
 		return t+ht;
 	}
 };
 
+/* The original method, with fixed point iteration */
+using BackwardEuler = BackwardEulerWith<FixedPointIteration>;
+
 };
 
 #endif
@@ -10,7 +10,7 @@ namespace IVP
 class BogackiShampine : public MethodEmbedded<BogackiShampine>
 {
 public:
-	BogackiShampine(float initial_step) : MethodEmbedded<BogackiShampine>(initial_step) { }
+	BogackiShampine(double initial_step) : MethodEmbedded<BogackiShampine>(initial_step) { }
 	BogackiShampine(unsigned int ns = 1) : MethodEmbedded<BogackiShampine>(ns) { }
 	BogackiShampine(int ns) : MethodEmbedded<BogackiShampine>((unsigned int)ns) { }
 
@@ -26,7 +26,8 @@ public:
 		f_t_yt = f(t+h         , y_t);
 		YType k4 = h*f_t_yt;
 
-		other = y_t + k1*(7.0/24.0)*k1 + (1.0/4.0)*k2 + (1.0/3.0)*k3 + (1.0/8.0)*k4;
+		//Embedded solution of the same step, written as a correction of the new y_t
+		other = y_t + (5.0/72.0)*k1 - (1.0/12.0)*k2 - (1.0/9.0)*k3 + (1.0/8.0)*k4;
 		return t+h;
 	}
 };
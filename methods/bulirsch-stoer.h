@@ -0,0 +1,171 @@
+#ifndef _IVP_BULIRSCH_STOER_H_
+#define _IVP_BULIRSCH_STOER_H_
+
+#include "method.h"
+#include "state.h"
+#include "thread-pool.h"
+#include <vector>
+#include <memory>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace IVP
+{
+
+/* \brief Thrown when rejections take the step size below the resolution of t (usually, f gives NaN or
+ * overflows there, or the problem is too stiff for the method).
+ */
+class StepSizeUnderflow : public std::runtime_error
+{
+public:
+	StepSizeUnderflow(const std::string& what) : std::runtime_error(what) { }
+};
+
+/**
+ * Gragg-Bulirsch-Stoer extrapolation with adaptive order and step (after ODEX, Hairer-Wanner):
+ *   - column j is Gragg's modified midpoint rule over the step with n_j = 2(j+1) substeps, which has an error
+ *     expansion in even powers of h,
+ *   - the columns are extrapolated to h = 0 with Aitken-Neville, so column k gives order 2(k+1),
+ *   - the difference between the last two diagonal values is the error estimate. Steps are rejected if it is
+ *     above tolerance*(1 + |y|) for some element, and the next order and step are chosen to minimize the
+ *     evaluations per unit of time.
+ *
+ * The columns are independent, so with a ThreadPool they are computed concurrently. Column j takes n_j - 1
+ * evaluations of f (plus f(t,y), common to all of them), so columns are paired as (0,k), (1,k-1)... for tasks
+ * of the same cost. f must then be callable from several threads at once.
+ *
+ * The column used by the last step is kept between steps. If the step size underflows (f keeps giving NaN or
+ * overflowing), next throws StepSizeUnderflow.
+ */
+class BulirschStoer : public Method<BulirschStoer>
+{
+	double _tolerance;
+	unsigned int max_columns;
+	std::shared_ptr<ThreadPool> pool;
+	std::vector<double> cost; //Evaluations of f up to each column
+
+	static unsigned int substeps(unsigned int j) { return 2*(j + 1); }
+
+public:
+	BulirschStoer(unsigned int ns = 1, double tol = 1.e-10, unsigned int columns = 8, const std::shared_ptr<ThreadPool>& _pool = nullptr) :
+		Method<BulirschStoer>(ns), _tolerance(tol), max_columns(std::max(columns,3u)), pool(_pool), cost(max_columns)
+	{
+		cost[0] = double(substeps(0));
+		for (unsigned int j = 1; j<max_columns; ++j) cost[j] = cost[j-1] + double(substeps(j) - 1);
+	}
+
+	double tolerance() const { return _tolerance; }
+	void set_tolerance(double t) { _tolerance = t; }
+	const std::shared_ptr<ThreadPool>& thread_pool() const { return pool; }
+
+	/* The first column is chosen from the tolerance (as in ODEX) */
+	template<typename YType, typename Function, typename real>
+	unsigned int between_steps_first(const Function& f, const real& t_ini, const YType& y_ini, const real& t_end) const
+	{
+		int k = int(-std::log10(tolerance() + 1.e-40)*0.6 + 0.5);
+		return (unsigned int)(std::max(2, std::min(int(max_columns) - 2, k)));
+	}
+
+	template<typename YType, typename Function, typename real>
+	real next(const Function& f, const real& t, YType& y_t, real& h, unsigned int& k) const
+	{
+		YType f_t = f(t,y_t);
+		std::vector<YType> table(max_columns,y_t);
+		std::vector<double> err(max_columns,0.0), step(max_columns,0.0);
+		while (true)
+		{
+			columns(f,t,y_t,f_t,h,k,table);
+			extrapolate(y_t,table,k,h,err,step);
+			unsigned int k_new = k;
+			if ((k>=2) && (cost[k-1]/step[k-1] < 0.8*cost[k]/step[k])) k_new = k-1;
+			if (err[k] <= 1.0)
+			{
+				real h_new = real(step[k_new]);
+				if ((k_new == k) && (k+1<max_columns) && (cost[k]/step[k] < 0.9*cost[k-1]/step[k-1]))
+				{	h_new = real(step[k]*cost[k+1]/cost[k]); k_new = k+1; }
+				y_t = std::move(table[k]);
+				real t_next = t + h;
+				h = h_new; k = k_new;
+				return t_next;
+			}
+			h = real(step[k_new]); k = k_new;
+			if (t + h == t) throw StepSizeUnderflow("BulirschStoer: step size underflow");
+		}
+	}
+
+private:
+	//table[j] = modified midpoint rule with substeps(j) substeps, for j = 0...k
+	template<typename YType, typename Function, typename real>
+	void columns(const Function& f, const real& t, const YType& y_t, const YType& f_t, const real& h, unsigned int k,
+		std::vector<YType>& table) const
+	{
+		auto pair = [&] (std::size_t i)
+		{
+			table[i] = midpoint(f,t,y_t,f_t,h,substeps(i));
+			if (k - i != i) table[k - i] = midpoint(f,t,y_t,f_t,h,substeps(k - i));
+		};
+		std::size_t tasks = k/2 + 1;
+		if (pool) pool->parallel_for(tasks,pair);
+		else for (std::size_t i = 0; i<tasks; ++i) pair(i);
+	}
+
+	template<typename YType, typename Function, typename real>
+	static YType midpoint(const Function& f, const real& t, const YType& y_t, const YType& f_t, const real& h, unsigned int n)
+	{
+		real hs = h/real(n);
+		YType z0 = y_t;
+		YType z1 = linear_combination(y_t,{double(hs)},f_t);
+		for (unsigned int m = 1; m<n; ++m)
+		{
+			YType z2 = linear_combination(z0,{2.0*double(hs)},f(t + real(m)*hs,z1));
+			z0 = std::move(z1); z1 = std::move(z2);
+		}
+		return z1;
+	}
+
+	/* Aitken-Neville over the columns, in place: table[j] ends up being the diagonal value of row j. Also the
+	 * scaled error and the optimal step size of each column.
+	 */
+	template<typename YType, typename real>
+	void extrapolate(const YType& y_t, std::vector<YType>& table, unsigned int k, const real& h,
+		std::vector<double>& err, std::vector<double>& step) const
+	{
+		std::vector<YType> row(1,table[0]), previous;
+		for (unsigned int j = 1; j<=k; ++j)
+		{
+			previous.swap(row);
+			row.assign(1,table[j]);
+			for (unsigned int l = 1; l<=j; ++l)
+			{
+				double r = double(substeps(j))/double(substeps(j - l));
+				row.push_back(linear_combination(row[l-1],{1.0/(r*r - 1.0),-1.0/(r*r - 1.0)},row[l-1],previous[l-1]));
+			}
+			table[j] = row[j];
+			err[j] = scaled_error(y_t,row[j],row[j-1]);
+			if (!std::isfinite(err[j])) err[j] = HUGE_VAL; //NaN or overflow: rejected, with the smallest step
+			double factor = 0.94*std::pow(0.65/std::max(err[j],1.e-300),1.0/double(2*j + 1));
+			step[j] = double(h)*std::max(0.02,std::min(4.0,factor));
+		}
+		err[0] = err[1]; step[0] = step[1];
+	}
+
+	template<typename YType>
+	double scaled_error(const YType& y_t, const YType& a, const YType& b) const
+	{
+		double sol = 0.0;
+		for (std::size_t i = 0; i<state_traits<YType>::size(a); ++i)
+		{
+			double scale = tolerance()*(1.0 + std::max(std::abs(double(state_traits<YType>::at(y_t,i))),
+			                                           std::abs(double(state_traits<YType>::at(a,i)))));
+			double e = std::abs(double(state_traits<YType>::at(a,i) - state_traits<YType>::at(b,i)))/scale;
+			if (!(e <= sol)) sol = e; //NaN counts as the largest error
+		}
+		return sol;
+	}
+};
+
+}; //namespace IVP
+
+#endif
@@ -0,0 +1,217 @@
+#ifndef _IVP_DELAY_H_
+#define _IVP_DELAY_H_
+
+#include "method.h"
+#include "state.h"
+#include <vector>
+
+namespace IVP {
+
+/* \brief Past steps of an integration, with cubic Hermite dense output between the ends of each step.
+ *
+ * Steps are kept in a ring buffer. Pushing a step drops the ones that end before (new end - max_delay), so
+ * the buffer only grows until it holds max_delay worth of steps. Lookups start at the last position found
+ * (amortized O(1) for monotone queries, as the stages of successive steps are) and fall back to a binary
+ * search. Times must increase.
+ */
+template<typename YType, typename real>
+class History
+{
+	struct Segment
+	{
+		real t0, h; YType y0, f0, y1, f1;
+	};
+	std::vector<Segment> ring;
+	std::size_t first, count;
+	mutable std::size_t cursor;
+	real max_delay;
+
+	const Segment& segment(std::size_t i) const { return ring[(first + i)%ring.size()]; }
+
+	void grow()
+	{
+		std::vector<Segment> bigger; bigger.reserve(2*ring.size());
+		for (std::size_t i = 0; i<count; ++i) bigger.push_back(segment(i));
+		bigger.resize(2*ring.size());
+		ring.swap(bigger); first = 0;
+	}
+
+	bool contains(std::size_t i, const real& t) const
+	{	return (segment(i).t0 <= t) && (t <= segment(i).t0 + segment(i).h); }
+
+	std::size_t locate(const real& t) const
+	{
+		if (cursor >= count) cursor = count - 1;
+		if (contains(cursor,t)) return cursor;
+		if ((cursor + 1 < count) && contains(cursor + 1,t)) return ++cursor;
+		//Binary search for the last segment that starts before t
+		std::size_t a = 0, b = count;
+		while (b - a > 1)
+		{
+			std::size_t m = (a + b)/2;
+			if (segment(m).t0 <= t) a = m; else b = m;
+		}
+		return cursor = a;
+	}
+
+public:
+	History(const real& _max_delay = real(0), std::size_t capacity = 16) :
+		ring(std::max(capacity,std::size_t(2))), first(0), count(0), cursor(0), max_delay(_max_delay) { }
+
+	bool empty()             const { return count == 0; }
+	std::size_t size()       const { return count; }
+	std::size_t capacity()   const { return ring.size(); }
+	real t_begin()           const { return segment(0).t0; }
+	real t_end()             const { return segment(count - 1).t0 + segment(count - 1).h; }
+
+	/* Step from (t0,y0) to (t0+h,y1), f0 and f1 being the derivatives at both ends */
+	void push(const real& t0, const real& h, const YType& y0, const YType& f0, const YType& y1, const YType& f1)
+	{
+		while ((count>0) && (segment(0).t0 + segment(0).h < t0 + h - max_delay)) { first = (first + 1)%ring.size(); --count; }
+		if (count == ring.size()) grow();
+		Segment& s = ring[(first + count)%ring.size()];
+		s.t0 = t0; s.h = h; s.y0 = y0; s.f0 = f0; s.y1 = y1; s.f1 = f1;
+		++count;
+		if (cursor >= count) cursor = count - 1;
+	}
+
+	/* State at time t. Outside of the stored steps this extrapolates the closest one. */
+	YType operator()(const real& t) const
+	{
+		const Segment& s = segment(locate(t));
+		return hermite(double((t - s.t0)/s.h),double(s.h),s.y0,s.f0,s.y1,s.f1);
+	}
+};
+
+/* \brief Delay differential equation y'(t) = f(t, y(t), lag), where lag(s) gives the past state y(s).
+ *
+ * initial(s) is the state before t_ini, and max_delay bounds t - s for every lag(s) that f asks for.
+ * There can be several delays, and they can depend on the state.
+ */
+template<typename Function, typename Initial>
+class DelayProblem
+{
+public:
+	Function f; Initial initial; double max_delay;
+	DelayProblem(const Function& _f, const Initial& _initial, double _max_delay) : f(_f), initial(_initial), max_delay(_max_delay) { }
+};
+
+template<typename Function, typename Initial>
+DelayProblem<Function,Initial> delay_problem(const Function& f, const Initial& initial, double max_delay)
+{	return DelayProblem<Function,Initial>(f,initial,max_delay); }
+
+/* \brief What f gets to look at the past: the initial function, the history or (within the first step) y_ini. */
+template<typename Initial, typename YType, typename real>
+class Lag
+{
+	const Initial& initial; const History<YType,real>& history;
+	real t_ini; const YType& y_ini;
+public:
+	Lag(const Initial& _initial, const History<YType,real>& _history, const real& _t_ini, const YType& _y_ini) :
+		initial(_initial), history(_history), t_ini(_t_ini), y_ini(_y_ini) { }
+
+	YType operator()(const real& s) const
+	{
+		if (s < t_ini) return initial(s);
+		else if (history.empty()) return y_ini;
+		else return history(s);
+	}
+};
+
+/* \brief The delay problem seen as an ordinary one by the base method: f(t, y, lag). */
+template<typename Function, typename Initial, typename YType, typename real>
+class DelayedFunction
+{
+	const DelayProblem<Function,Initial>& problem;
+	Lag<Initial,YType,real> lag;
+public:
+	DelayedFunction(const DelayProblem<Function,Initial>& _problem, const History<YType,real>& history, const real& t_ini, const YType& y_ini) :
+		problem(_problem), lag(problem.initial,history,t_ini,y_ini) { }
+
+	template<typename R, typename Y>
+	YType operator()(const R& t, const Y& y) const { return problem.f(real(t),y,lag); }
+};
+
+template<typename YType, typename real, typename BaseBetweenSteps>
+struct DelayData
+{
+	History<YType,real> history;
+	real t_ini; YType y_ini, f_t;
+	BaseBetweenSteps base;
+};
+
+template<typename YType, typename real>
+struct DelayData<YType,real,void>
+{
+	History<YType,real> history;
+	real t_ini; YType y_ini, f_t;
+};
+
+/* \brief Integrates a DelayProblem with BaseMethod (any method, also Adaptive ones).
+ *
+ * Each accepted step is stored in the history with the derivatives at both ends (one extra evaluation of f per
+ * step, that is reused as the first derivative of the next one). Lags that fall within the current step (delays
+ * shorter than the step) are extrapolated from the last step, so for full order keep steps under the minimum delay.
+ */
+template<typename BaseMethod>
+class Delay : public Method<Delay<BaseMethod>>
+{
+	BaseMethod _base_method;
+
+	template<typename YType, typename Function, typename Initial, typename real>
+	using Delayed = DelayedFunction<Function,Initial,YType,real>;
+	template<typename YType, typename Function, typename Initial, typename real>
+	using BaseBetweenSteps = typename Type<BaseMethod,YType,Delayed<YType,Function,Initial,real>,real>::BetweenSteps;
+
+public:
+	Delay(const BaseMethod& bm = BaseMethod()) : Method<Delay<BaseMethod>>(1u), _base_method(bm) { }
+
+	const BaseMethod& base_method() const { return _base_method; }
+	int expected_steps()              const { return base_method().expected_steps(); }
+	template<typename real>
+	real step(const real& total)      const { return base_method().step(total); }
+
+	template<typename YType, typename Function, typename Initial, typename real>
+	DelayData<YType,real,BaseBetweenSteps<YType,Function,Initial,real>>
+		between_steps_first(const DelayProblem<Function,Initial>& f, const real& t_ini, const YType& y_ini, const real& t_end) const
+	{
+		DelayData<YType,real,BaseBetweenSteps<YType,Function,Initial,real>> data{ History<YType,real>(real(f.max_delay)), t_ini, y_ini, y_ini };
+		Delayed<YType,Function,Initial,real> g(f,data.history,t_ini,data.y_ini);
+		data.f_t = g(t_ini,y_ini);
+		base_between_steps_first(data,g,t_ini,y_ini,t_end);
+		return data;
+	}
+
+	template<typename YType, typename Function, typename Initial, typename real, typename Data>
+	real next(const DelayProblem<Function,Initial>& f, const real& t, YType& y_t, real& ht, Data& data) const
+	{
+		Delayed<YType,Function,Initial,real> g(f,data.history,data.t_ini,data.y_ini);
+		YType y_prev = y_t;
+		real t_next = base_next(g,t,y_t,ht,data);
+		YType f_next = g(t_next,y_t);
+		data.history.push(t,t_next - t,y_prev,data.f_t,y_t,f_next);
+		data.f_t = f_next;
+		return t_next;
+	}
+
+private:
+	template<typename YType, typename real, typename G>
+	void base_between_steps_first(DelayData<YType,real,void>& data, const G& g, const real& t_ini, const YType& y_ini, const real& t_end) const { }
+	template<typename YType, typename real, typename BS, typename G>
+	void base_between_steps_first(DelayData<YType,real,BS>& data, const G& g, const real& t_ini, const YType& y_ini, const real& t_end) const
+	{	data.base = wrapped_between_steps_first(base_method(),g,t_ini,y_ini,t_end); }
+
+	template<typename G, typename YType, typename real>
+	real base_next(const G& g, const real& t, YType& y_t, real& ht, DelayData<YType,real,void>& data) const
+	{	return base_method().next(g,t,y_t,ht); }
+	template<typename G, typename YType, typename real, typename BS>
+	real base_next(const G& g, const real& t, YType& y_t, real& ht, DelayData<YType,real,BS>& data) const
+	{	return base_method().next(g,t,y_t,ht,data.base); }
+};
+
+template<typename BaseMethod>
+Delay<BaseMethod> delay(const BaseMethod& bm) { return Delay<BaseMethod>(bm); }
+
+}; //namespace IVP
+
+#endif
@@ -0,0 +1,124 @@
+#ifndef _IVP_DENSE_H_
+#define _IVP_DENSE_H_
+
+#include <vector>
+#include <cmath>
+#include <utility>
+#include <type_traits>
+
+namespace IVP {
+
+template<typename T> class DenseMatrix;
+
+template<typename T> struct is_dense_matrix : std::false_type { };
+template<typename T> struct is_dense_matrix<DenseMatrix<T>> : std::true_type { };
+
+/* \brief Row-major dense matrix, for the Jacobians of implicit methods. */
+template<typename T>
+class DenseMatrix
+{
+	std::size_t _rows, _cols;
+	std::vector<T> _data;
+public:
+	DenseMatrix(std::size_t r = 0, std::size_t c = 0) : _rows(r), _cols(c), _data(r*c,T(0)) { }
+
+	std::size_t rows() const { return _rows; }
+	std::size_t cols() const { return _cols; }
+	const T& operator()(std::size_t i, std::size_t j) const { return _data[i*_cols + j]; }
+	      T& operator()(std::size_t i, std::size_t j)       { return _data[i*_cols + j]; }
+	const T* data() const { return _data.data(); }
+	      T* data()       { return _data.data(); }
+
+	bool operator==(const DenseMatrix& that) const { return (_rows == that._rows) && (_cols == that._cols) && (_data == that._data); }
+	bool operator!=(const DenseMatrix& that) const { return !(*this == that); }
+
+	//Matrix-vector product, so that a DenseMatrix can be the c1 of a LinearProblem. Vector is a state, neither a
+	//scalar nor another matrix
+	template<typename Vector, typename = typename std::enable_if<!std::is_arithmetic<Vector>::value &&
+		!is_dense_matrix<Vector>::value>::type>
+	friend Vector operator*(const DenseMatrix& m, const Vector& v)
+	{
+		Vector sol = v;
+		for (std::size_t i = 0; i<m.rows(); ++i)
+		{
+			typename std::decay<decltype(m(i,0)*v[0])>::type s(0);
+			for (std::size_t j = 0; j<m.cols(); ++j) s += m(i,j)*v[j];
+			sol[i] = s;
+		}
+		return sol;
+	}
+
+	//Matrix arithmetic, for the propagators of a ConstantLinearProblem whose c1 is a DenseMatrix
+	friend DenseMatrix operator*(const DenseMatrix& a, const DenseMatrix& b)
+	{
+		DenseMatrix sol(a.rows(),b.cols());
+		for (std::size_t i = 0; i<a.rows(); ++i) for (std::size_t k = 0; k<a.cols(); ++k)
+		{
+			T aik = a(i,k);
+			if (aik != T(0)) for (std::size_t j = 0; j<b.cols(); ++j) sol(i,j) += aik*b(k,j);
+		}
+		return sol;
+	}
+
+	friend DenseMatrix operator+(const DenseMatrix& a, const DenseMatrix& b)
+	{	DenseMatrix sol = a; for (std::size_t i = 0; i<sol._data.size(); ++i) sol._data[i] += b._data[i]; return sol; }
+
+	template<typename S, typename = typename std::enable_if<std::is_arithmetic<S>::value>::type>
+	friend DenseMatrix operator*(const S& s, const DenseMatrix& a)
+	{	DenseMatrix sol = a; for (T& x : sol._data) x *= T(s); return sol; }
+};
+
+/* \brief LU factorization with partial pivoting, reused for several right hand sides. */
+template<typename T>
+class DenseLU
+{
+	DenseMatrix<T> lu;
+	std::vector<std::size_t> pivots;
+	bool _singular = false;
+public:
+	DenseLU() { }
+	DenseLU(const DenseMatrix<T>& a) { factor(a); }
+
+	/* A zero pivot was found: solve leaves the unknowns of those columns as they are, so its result only
+	 * solves the system if it is consistent. Callers that need a solution should check this.
+	 */
+	bool singular() const { return _singular; }
+
+	void factor(const DenseMatrix<T>& a)
+	{
+		lu = a; std::size_t n = lu.rows();
+		pivots.resize(n); _singular = false;
+		for (std::size_t k = 0; k<n; ++k)
+		{
+			std::size_t p = k;
+			for (std::size_t i = k+1; i<n; ++i) if (std::abs(lu(i,k)) > std::abs(lu(p,k))) p = i;
+			pivots[k] = p;
+			if (p != k) for (std::size_t j = 0; j<n; ++j) std::swap(lu(k,j),lu(p,j));
+			if (lu(k,k) == T(0)) { _singular = true; continue; } //That column is left as is
+			T inv = T(1)/lu(k,k);
+			for (std::size_t i = k+1; i<n; ++i)
+			{
+				T l = (lu(i,k) *= inv);
+				if (l != T(0)) for (std::size_t j = k+1; j<n; ++j) lu(i,j) -= l*lu(k,j);
+			}
+		}
+	}
+
+	//Solves in place: b becomes x such that a*x = b
+	template<typename Vector>
+	void solve(Vector& b) const
+	{
+		std::size_t n = lu.rows();
+		for (std::size_t k = 0; k<n; ++k) if (pivots[k] != k) std::swap(b[k],b[pivots[k]]);
+		for (std::size_t i = 1; i<n; ++i) for (std::size_t j = 0; j<i; ++j) b[i] -= lu(i,j)*b[j];
+		for (std::size_t i = n; i-->0; )
+		{
+			for (std::size_t j = i+1; j<n; ++j) b[i] -= lu(i,j)*b[j];
+			if (lu(i,i) != T(0)) b[i] /= lu(i,i);
+		}
+	}
+};
+
+}; //namespace IVP
+
+#endif
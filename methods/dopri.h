@@ -3,6 +3,7 @@
 
 #include "method.h"
 #include "problem.h"
+#include "state.h"
 #include <cmath>
 
 namespace IVP
@@ -22,7 +23,7 @@ public:
 class Dopri : public MethodEmbedded<Dopri>
 {
 public:
-	Dopri(float initial_step) : MethodEmbedded<Dopri>(initial_step) { }
+	Dopri(double initial_step) : MethodEmbedded<Dopri>(initial_step) { }
 	Dopri(unsigned int ns = 1) : MethodEmbedded<Dopri>(ns) { }
 	Dopri(int ns) : MethodEmbedded<Dopri>((unsigned int)ns) { }
 
@@ -32,17 +33,20 @@ public:
 	real next_embedded(const Function& f, real t, YType& y_t, real& h, YType& f_t_yt, YType& other) const
 	{
 		YType k0 = h*f_t_yt;
-		YType k1 = h*f(t+h/5.0     , y_t + k0/5.0);
-		YType k2 = h*f(t+h*3.0/10.0, y_t + k0*3.0/40.0       + k1*9.0/40.0);
-		YType k3 = h*f(t+h*4.0/5.0 , y_t + k0*44.0/45.0      - k1*56.0/15.0      + k2*32.0/9.0);
-		YType k4 = h*f(t+h*8.0/9.0 , y_t + k0*19372.0/6561.0 - k1*25360.0/2187.0 + k2*64448.0/6561.0 - k3*212.0/729.0);
-		YType k5 = h*f(t+h         , y_t + k0*9017.0/3168.0  - k1*355.0/33.0     + k2*46732.0/5247.0 + k3*49.0/176.0 - k4*5103.0/18656.0);
-		y_t = y_t + k0*35.0/384.0     + k2*500.0/1113.0   + k3*125.0/192.0   - k4*2187.0/6784.0 + k5*11.0/84.0;
+		YType k1 = h*f(t+h/5.0     , linear_combination(y_t, {1.0/5.0}, k0));
+		YType k2 = h*f(t+h*3.0/10.0, linear_combination(y_t, {3.0/40.0, 9.0/40.0}, k0, k1));
+		YType k3 = h*f(t+h*4.0/5.0 , linear_combination(y_t, {44.0/45.0, -56.0/15.0, 32.0/9.0}, k0, k1, k2));
+		YType k4 = h*f(t+h*8.0/9.0 , linear_combination(y_t, 
+			{19372.0/6561.0, -25360.0/2187.0, 64448.0/6561.0, -212.0/729.0}, k0, k1, k2, k3));
+		YType k5 = h*f(t+h         , linear_combination(y_t, 
+			{9017.0/3168.0, -355.0/33.0, 46732.0/5247.0, 49.0/176.0, -5103.0/18656.0}, k0, k1, k2, k3, k4));
+		linear_combination_inplace(y_t, {35.0/384.0, 500.0/1113.0, 125.0/192.0, -2187.0/6784.0, 11.0/84.0}, k0, k2, k3, k4, k5);
 		f_t_yt = f(t+h         , y_t);
 		YType k6 = h*f_t_yt;
 
-		other = y_t + (5179.0/57600.0)*k0 + (7571.0/16695.0)*k2 + (393.0/640.0)*k3 - (92097.0/339200.0)*k4
-					+ (187.0/2100.0)*k5 + (1.0/40.0)*k6;
+		//Embedded solution of the same step, written as a correction of the new y_t
+		other = linear_combination(y_t, 
+			{-71.0/57600.0, 71.0/16695.0, -71.0/1920.0, 17253.0/339200.0, -22.0/525.0, 1.0/40.0}, k0, k2, k3, k4, k5, k6);
 		return t+h;
 	}
 
@@ -50,19 +54,49 @@ public:
 	real next_embedded(const LinearProblem<F0, F1>& f, real t, YType& y_t, real& h, YType& f_t_yt, YType& other) const
 	{
 		YType k0 = h*f_t_yt;
-		YType k1 = h*f(t+h/5.0     , y_t + k0/5.0);
-		YType k2 = h*f(t+h*3.0/10.0, y_t + k0*3.0/40.0       + k1*9.0/40.0);
-		YType k3 = h*f(t+h*4.0/5.0 , y_t + k0*44.0/45.0      - k1*56.0/15.0      + k2*32.0/9.0);
-		YType k4 = h*f(t+h*8.0/9.0 , y_t + k0*19372.0/6561.0 - k1*25360.0/2187.0 + k2*64448.0/6561.0 - k3*212.0/729.0);
+		YType k1 = h*f(t+h/5.0     , linear_combination(y_t, {1.0/5.0}, k0));
+		YType k2 = h*f(t+h*3.0/10.0, linear_combination(y_t, {3.0/40.0, 9.0/40.0}, k0, k1));
+		YType k3 = h*f(t+h*4.0/5.0 , linear_combination(y_t, {44.0/45.0, -56.0/15.0, 32.0/9.0}, k0, k1, k2));
+		YType k4 = h*f(t+h*8.0/9.0 , linear_combination(y_t, 
+			{19372.0/6561.0, -25360.0/2187.0, 64448.0/6561.0, -212.0/729.0}, k0, k1, k2, k3));
 		auto c05 = f.c0(t+h); auto c15 = f.c1(t+h);
-		YType k5 = h*(c15
-			*(y_t + k0*9017.0/3168.0  - k1*355.0/33.0     + k2*46732.0/5247.0 + k3*49.0/176.0 - k4*5103.0/18656.0) + c05);
-		y_t = y_t + k0*35.0/384.0     + k2*500.0/1113.0   + k3*125.0/192.0   - k4*2187.0/6784.0 + k5*11.0/84.0;
+		YType k5 = h*(c15*linear_combination(y_t, 
+			{9017.0/3168.0, -355.0/33.0, 46732.0/5247.0, 49.0/176.0, -5103.0/18656.0}, k0, k1, k2, k3, k4) + c05);
+		linear_combination_inplace(y_t, {35.0/384.0, 500.0/1113.0, 125.0/192.0, -2187.0/6784.0, 11.0/84.0}, k0, k2, k3, k4, k5);
 		f_t_yt = c15*y_t + c05; 
 		YType k6 = h*f_t_yt;
 
-		other = y_t + (5179.0/57600.0)*k0 + (7571.0/16695.0)*k2 + (393.0/640.0)*k3 - (92097.0/339200.0)*k4
-					+ (187.0/2100.0)*k5 + (1.0/40.0)*k6;
+		//Embedded solution of the same step, written as a correction of the new y_t
+		other = linear_combination(y_t, 
+			{-71.0/57600.0, 71.0/16695.0, -71.0/1920.0, 17253.0/339200.0, -22.0/525.0, 1.0/40.0}, k0, k2, k3, k4, k5, k6);
+		return t+h;
+	}
+
+	/* For constant coefficients both the solution and the embedded one are propagators. The FSAL evaluation
+	 * is not needed anymore, so the data between steps are the propagators themselves.
+	 */
+	template<typename YType, typename C1, typename C0, typename real>  
+	std::pair<LinearPropagatorFor<C1,YType,real>,LinearPropagatorFor<C1,YType,real>> 
+		between_steps_first(const ConstantLinearProblem<C1, C0>& f, const real& t_ini, const YType& y_ini, const real& t_end) const
+	{
+		return std::make_pair(LinearPropagatorFor<C1,YType,real>(),LinearPropagatorFor<C1,YType,real>());
+	}
+
+	/* R(z) = 1 + z + z^2/2 + z^3/6 + z^4/24 + z^5/120 + z^6/600 */
+	static std::array<double,6> stability_polynomial() 
+	{ return {{ 1.0, 1.0/2.0, 1.0/6.0, 1.0/24.0, 1.0/120.0, 1.0/600.0 }}; }
+	/* Embedded solution (including the FSAL stage) */
+	static std::array<double,7> stability_polynomial_embedded() 
+	{ return {{ 1.0, 1.0/2.0, 1.0/6.0, 1.0/24.0, 1097.0/120000.0, 161.0/120000.0, 1.0/24000.0 }}; }
+
+	template<typename YType, typename C1, typename C0, typename real, typename Matrix>  
+	real next_embedded(const ConstantLinearProblem<C1, C0>& f, real t, YType& y_t, real& h, 
+		std::pair<LinearPropagator<Matrix,YType,real>,LinearPropagator<Matrix,YType,real>>& propagators, YType& other) const
+	{
+		propagators.first.update(f,h,stability_polynomial());
+		propagators.second.update(f,h,stability_polynomial_embedded());
+		other = propagators.second(y_t);
+		y_t = propagators.first(y_t);
 		return t+h;
 	}
 };
@@ -0,0 +1,111 @@
+#ifndef _IVP_DUAL_H_
+#define _IVP_DUAL_H_
+
+#include "state.h"
+#include <array>
+#include <cmath>
+#include <type_traits>
+
+namespace IVP {
+
+/* \brief Dual number with N directional derivatives (vector forward mode automatic differentiation).
+ *
+ * Passing Dual values through a templated f gives N columns of its Jacobian in a single evaluation. The
+ * derivative loops have a fixed length N, so they vectorize when N is a multiple of the SIMD width.
+ * Mathematical functions are found by argument dependent lookup: f must call them unqualified
+ * (using std::sin; ... sin(y)) for Dual values to work.
+ */
+template<typename T, std::size_t N>
+class Dual
+{
+public:
+	T v; std::array<T,N> d;
+
+	Dual() : v(0), d{} { }
+	Dual(const T& _v) : v(_v), d{} { }
+	template<typename S, typename = typename std::enable_if<std::is_arithmetic<S>::value>::type>
+	Dual(const S& _v) : v(T(_v)), d{} { }
+
+	const T& value() const { return v; }
+	const T& derivative(std::size_t i) const { return d[i]; }
+
+	Dual& operator+=(const Dual& b) { v += b.v; for (std::size_t i = 0; i<N; ++i) d[i] += b.d[i]; return (*this); }
+	Dual& operator-=(const Dual& b) { v -= b.v; for (std::size_t i = 0; i<N; ++i) d[i] -= b.d[i]; return (*this); }
+	Dual& operator*=(const Dual& b) { for (std::size_t i = 0; i<N; ++i) d[i] = d[i]*b.v + v*b.d[i]; v *= b.v; return (*this); }
+	Dual& operator/=(const Dual& b)
+	{	T inv = T(1)/b.v; for (std::size_t i = 0; i<N; ++i) d[i] = (d[i] - v*inv*b.d[i])*inv; v *= inv; return (*this); }
+
+	friend Dual operator+(Dual a, const Dual& b) { return a += b; }
+	friend Dual operator-(Dual a, const Dual& b) { return a -= b; }
+	friend Dual operator*(Dual a, const Dual& b) { return a *= b; }
+	friend Dual operator/(Dual a, const Dual& b) { return a /= b; }
+	friend Dual operator-(Dual a) { a.v = -a.v; for (std::size_t i = 0; i<N; ++i) a.d[i] = -a.d[i]; return a; }
+	friend Dual operator+(const Dual& a) { return a; }
+
+	template<typename S, typename = typename std::enable_if<std::is_arithmetic<S>::value>::type>
+	friend Dual operator+(Dual a, const S& s) { a.v += T(s); return a; }
+	template<typename S, typename = typename std::enable_if<std::is_arithmetic<S>::value>::type>
+	friend Dual operator+(const S& s, Dual a) { a.v += T(s); return a; }
+	template<typename S, typename = typename std::enable_if<std::is_arithmetic<S>::value>::type>
+	friend Dual operator-(Dual a, const S& s) { a.v -= T(s); return a; }
+	template<typename S, typename = typename std::enable_if<std::is_arithmetic<S>::value>::type>
+	friend Dual operator-(const S& s, const Dual& a) { return Dual(s) - a; }
+	template<typename S, typename = typename std::enable_if<std::is_arithmetic<S>::value>::type>
+	friend Dual operator*(Dual a, const S& s) { a.v *= T(s); for (std::size_t i = 0; i<N; ++i) a.d[i] *= T(s); return a; }
+	template<typename S, typename = typename std::enable_if<std::is_arithmetic<S>::value>::type>
+	friend Dual operator*(const S& s, const Dual& a) { return a*s; }
+	template<typename S, typename = typename std::enable_if<std::is_arithmetic<S>::value>::type>
+	friend Dual operator/(const Dual& a, const S& s) { return a*(T(1)/T(s)); }
+	template<typename S, typename = typename std::enable_if<std::is_arithmetic<S>::value>::type>
+	friend Dual operator/(const S& s, const Dual& a) { return Dual(s)/a; }
+
+	friend bool operator< (const Dual& a, const Dual& b) { return a.v <  b.v; }
+	friend bool operator> (const Dual& a, const Dual& b) { return a.v >  b.v; }
+	friend bool operator<=(const Dual& a, const Dual& b) { return a.v <= b.v; }
+	friend bool operator>=(const Dual& a, const Dual& b) { return a.v >= b.v; }
+	friend bool operator==(const Dual& a, const Dual& b) { return a.v == b.v; }
+	friend bool operator!=(const Dual& a, const Dual& b) { return a.v != b.v; }
+
+	//Chain rule: value g(v) with derivative dg(v)
+	friend Dual chain(const Dual& a, const T& g, const T& dg)
+	{	Dual sol; sol.v = g; for (std::size_t i = 0; i<N; ++i) sol.d[i] = dg*a.d[i]; return sol; }
+
+	friend Dual sin(const Dual& a)  { return chain(a,std::sin(a.v),std::cos(a.v)); }
+	friend Dual cos(const Dual& a)  { return chain(a,std::cos(a.v),-std::sin(a.v)); }
+	friend Dual tan(const Dual& a)  { T t = std::tan(a.v); return chain(a,t,T(1) + t*t); }
+	friend Dual exp(const Dual& a)  { T e = std::exp(a.v); return chain(a,e,e); }
+	friend Dual log(const Dual& a)  { return chain(a,std::log(a.v),T(1)/a.v); }
+	friend Dual sqrt(const Dual& a) { T s = std::sqrt(a.v); return chain(a,s,T(0.5)/s); }
+	friend Dual tanh(const Dual& a) { T t = std::tanh(a.v); return chain(a,t,T(1) - t*t); }
+	friend Dual sinh(const Dual& a) { return chain(a,std::sinh(a.v),std::cosh(a.v)); }
+	friend Dual cosh(const Dual& a) { return chain(a,std::cosh(a.v),std::sinh(a.v)); }
+	friend Dual atan(const Dual& a) { return chain(a,std::atan(a.v),T(1)/(T(1) + a.v*a.v)); }
+	friend Dual abs(const Dual& a)  { return (a.v<T(0))?-a:a; }
+	friend Dual fabs(const Dual& a) { return abs(a); }
+	friend Dual pow(const Dual& a, const T& p) { return chain(a,std::pow(a.v,p),p*std::pow(a.v,p - T(1))); }
+	friend Dual pow(const Dual& a, const Dual& b) { return exp(b*log(a)); }
+};
+
+/* A Dual is a single element whose magnitude is that of its value. */
+template<typename T, std::size_t N>
+struct state_traits<Dual<T,N>>
+{
+	using value_type = Dual<T,N>;
+
+	static std::size_t size(const Dual<T,N>& v)                  { return 1; }
+	static const Dual<T,N>& at(const Dual<T,N>& v, std::size_t i) { return v; }
+	static Dual<T,N>& at(Dual<T,N>& v, std::size_t i)             { return v; }
+	static Dual<T,N> norm(const Dual<T,N>& v)                     { return abs(v); }
+
+	template<std::size_t M, typename... K>
+	static Dual<T,N> linear_combination(const Dual<T,N>& y, const double (&c)[M], const K&... k)
+	{	return fused::chained(y,c,std::array<const Dual<T,N>*,M>{{ &k... }},std::make_index_sequence<M>()); }
+
+	template<std::size_t M, typename... K>
+	static void linear_combination_inplace(Dual<T,N>& y, const double (&c)[M], const K&... k)
+	{	y = linear_combination(y,c,k...); }
+};
+
+}; //namespace IVP
+
+#endif
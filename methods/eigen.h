@@ -0,0 +1,56 @@
+#ifndef _IVP_EIGEN_H_
+#define _IVP_EIGEN_H_
+
+/* Eigen dense vectors as YType. Not included by ivp.h, so Eigen is only needed if you include this.
+ */
+#include <Eigen/Core>
+#include "state.h"
+
+namespace IVP {
+
+template<typename Scalar, int Rows, int Options, int MaxRows>
+struct state_traits<Eigen::Matrix<Scalar,Rows,1,Options,MaxRows,1>, typename std::enable_if<fused::is_kernel_scalar<Scalar>::value>::type> :
+	public contiguous_state_traits<Eigen::Matrix<Scalar,Rows,1,Options,MaxRows,1>,Scalar>
+{
+	using Vector = Eigen::Matrix<Scalar,Rows,1,Options,MaxRows,1>;
+	static Vector like(const Vector& v) { return Vector(v.size()); }
+	static Scalar norm(const Vector& v) { return (v.size()>0)?v.template lpNorm<Eigen::Infinity>():Scalar(0); }
+
+	template<typename S> using rebind = Eigen::Matrix<S,Rows,1,Options,MaxRows,1>;
+	template<typename S> static rebind<S> cast(const Vector& v) { return v.template cast<S>(); }
+};
+
+/* Any other Eigen vector (expressions, other scalar types...) is evaluated by Eigen itself
+ */
+template<typename Derived>
+struct state_traits<Derived, typename std::enable_if<std::is_base_of<Eigen::MatrixBase<Derived>,Derived>::value &&
+		!(std::is_same<Derived,typename Derived::PlainObject>::value && fused::is_kernel_scalar<typename Derived::Scalar>::value)>::type>
+{
+	using value_type = typename Derived::Scalar;
+	using Plain = typename Derived::PlainObject;
+
+	static std::size_t size(const Derived& v)                     { return v.size(); }
+	static value_type at(const Derived& v, std::size_t i)         { return v(i); }
+	static value_type norm(const Derived& v) { return (v.size()>0)?v.template lpNorm<Eigen::Infinity>():value_type(0); }
+
+	template<typename S> using rebind = Eigen::Matrix<S,Plain::RowsAtCompileTime,Plain::ColsAtCompileTime>;
+	template<typename S> static rebind<S> cast(const Derived& v) { return v.template cast<S>(); }
+
+	template<std::size_t N, typename... K>
+	static Plain linear_combination(const Derived& y, const double (&c)[N], const K&... k)
+	{	return chained(y,c,std::array<const Derived*,N>{{ &k... }},std::make_index_sequence<N>()); }
+
+	template<std::size_t N, typename... K>
+	static void linear_combination_inplace(Derived& y, const double (&c)[N], const K&... k)
+	{	y = linear_combination(y,c,k...); }
+
+private:
+	//Eigen fuses the whole expression into a single loop when assigning it
+	template<std::size_t N, std::size_t... I>
+	static Plain chained(const Derived& y, const double (&c)[N], const std::array<const Derived*,N>& k, std::index_sequence<I...>)
+	{	return (y + ... + (value_type(c[I])*(*k[I]))); }
+};
+
+}; //namespace IVP
+
+#endif
@@ -2,38 +2,39 @@
 #define _IVP_EULERTRAPEZOIDAL_H_
 
 #include "method.h"
+#include "implicit-solver.h"
 
 namespace IVP
 {
 
-class EulerTrapezoidal : public Method<EulerTrapezoidal>
+/**
+ * y_{n+1} = y_n + h/2*(f(t_n,y_n) + f(t_{n+1},y_{n+1})), solved by Solver (see implicit-solver.h) from the
+ * explicit Euler guess.
+ */
+template<typename Solver>
+class EulerTrapezoidalWith : public Method<EulerTrapezoidalWith<Solver>>
 {
-	float tolerance;
+	double tolerance;
+	Solver solver;
 public:
-	EulerTrapezoidal(float s, float tol) :   Method<EulerTrapezoidal>(s),tolerance(tol)  { }
-	EulerTrapezoidal(unsigned int ns = 1, float tol = 1.e-3) : Method<EulerTrapezoidal>(ns),tolerance(tol) { }
+	EulerTrapezoidalWith(double s, double tol, const Solver& _solver = Solver()) :   
+		Method<EulerTrapezoidalWith<Solver>>(s),tolerance(tol),solver(_solver)  { }
+	EulerTrapezoidalWith(unsigned int ns = 1, double tol = 1.e-3, const Solver& _solver = Solver()) : 
+		Method<EulerTrapezoidalWith<Solver>>(ns),tolerance(tol),solver(_solver) { }
 
 	template<typename YType, typename Function, typename real>  
 	real next(const Function& f, const real& t, YType& y_t, const real& ht) const
 	{
-		const unsigned int max_iterations = 10000;
-		unsigned int i = 0;
 		YType f_tyt = f(t,y_t);
-		YType y_ti =  y_t + ht*f_tyt;
-		real t_h1 = t+ht;
-		YType y_ti1 = y_t + ht*real(0.5)*(f_tyt + f(t_h1,y_ti));
-
-		while ( (real(norm(y_ti1 - y_ti))>real(tolerance))  && (i<max_iterations))
-		{
-			y_ti = y_ti1; 
-			y_ti1 = y_t + ht*real(0.5)*(f_tyt + f(t_h1,y_ti));
-			i++;
-		}
-		y_t = y_ti1;
-		return t_h1;
+		real half = ht*real(0.5);
+		y_t = solver.solve(f,t+ht,y_t + half*f_tyt,half,y_t + ht*f_tyt,tolerance);
+		return t+ht;
 	}
 };
 
+/* The original method, with fixed point iteration */
+using EulerTrapezoidal = EulerTrapezoidalWith<FixedPointIteration>;
+
 };
 
 #endif
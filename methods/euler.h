@@ -11,7 +11,7 @@ class Euler : public Method<Euler>
 public:
 //	This should work but doesn't. Tested on gcc 2.7
 //	using Method<Euler>::Method;
-	Euler(float s) :   Method<Euler>(s)  { }
+	Euler(double s) :   Method<Euler>(s)  { }
 	Euler(unsigned int ns) : Method<Euler>(ns) { }
 	Euler(int ns = 1) : Method<Euler>((unsigned int)ns) { }
 
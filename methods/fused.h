@@ -0,0 +1,155 @@
+#ifndef _IVP_FUSED_H_
+#define _IVP_FUSED_H_
+
+#include <array>
+#include <cstddef>
+#include <utility>
+#include <type_traits>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define IVP_FUSED_X86
+#include <immintrin.h>
+#endif
+
+namespace IVP {
+
+/* \brief Fused linear combinations y + c[0]*k[0] + c[1]*k[1] + ... of the stages of a method.
+ *
+ * In general this is just the chain of operators over YType. However, when YType is contiguous storage of 
+ * floats or doubles (see state_traits in state.h), everything is done in a single pass over memory with 
+ * hand-vectorized kernels (AVX-512, AVX2+FMA or plain C++, chosen at runtime).
+ */
+namespace fused {
+
+enum class Isa { generic, avx2, avx512 };
+
+inline Isa detect_isa()
+{
+#ifdef IVP_FUSED_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f")) return Isa::avx512;
+	if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return Isa::avx2;
+#endif
+	return Isa::generic;
+}
+
+inline Isa isa() { static const Isa detected = detect_isa(); return detected; }
+
+inline const char* isa_name(Isa i)
+{ return (i==Isa::avx512)?"avx512":((i==Isa::avx2)?"avx2":"generic"); }
+
+template<typename T, std::size_t N>
+void kernel_generic(T* out, const T* y, const std::array<const T*,N>& k, const std::array<T,N>& c, std::size_t from, std::size_t to)
+{
+	for (std::size_t i = from; i<to; ++i)
+	{
+		T acc = y[i];
+		for (std::size_t j = 0; j<N; ++j) acc += c[j]*k[j][i];
+		out[i] = acc;
+	}
+}
+
+#ifdef IVP_FUSED_X86
+template<std::size_t N>
+__attribute__((target("avx2,fma")))
+void kernel_avx2(double* out, const double* y, const std::array<const double*,N>& k, const std::array<double,N>& c, std::size_t n)
+{
+	__m256d vc[N];
+	for (std::size_t j = 0; j<N; ++j) vc[j] = _mm256_set1_pd(c[j]);
+	std::size_t i = 0;
+	for (; i+4<=n; i+=4)
+	{
+		__m256d acc = _mm256_loadu_pd(y+i);
+		for (std::size_t j = 0; j<N; ++j) acc = _mm256_fmadd_pd(vc[j],_mm256_loadu_pd(k[j]+i),acc);
+		_mm256_storeu_pd(out+i,acc);
+	}
+	kernel_generic(out,y,k,c,i,n);
+}
+
+template<std::size_t N>
+__attribute__((target("avx2,fma")))
+void kernel_avx2(float* out, const float* y, const std::array<const float*,N>& k, const std::array<float,N>& c, std::size_t n)
+{
+	__m256 vc[N];
+	for (std::size_t j = 0; j<N; ++j) vc[j] = _mm256_set1_ps(c[j]);
+	std::size_t i = 0;
+	for (; i+8<=n; i+=8)
+	{
+		__m256 acc = _mm256_loadu_ps(y+i);
+		for (std::size_t j = 0; j<N; ++j) acc = _mm256_fmadd_ps(vc[j],_mm256_loadu_ps(k[j]+i),acc);
+		_mm256_storeu_ps(out+i,acc);
+	}
+	kernel_generic(out,y,k,c,i,n);
+}
+
+template<std::size_t N>
+__attribute__((target("avx512f")))
+void kernel_avx512(double* out, const double* y, const std::array<const double*,N>& k, const std::array<double,N>& c, std::size_t n)
+{
+	__m512d vc[N];
+	for (std::size_t j = 0; j<N; ++j) vc[j] = _mm512_set1_pd(c[j]);
+	std::size_t i = 0;
+	for (; i+8<=n; i+=8)
+	{
+		__m512d acc = _mm512_loadu_pd(y+i);
+		for (std::size_t j = 0; j<N; ++j) acc = _mm512_fmadd_pd(vc[j],_mm512_loadu_pd(k[j]+i),acc);
+		_mm512_storeu_pd(out+i,acc);
+	}
+	kernel_generic(out,y,k,c,i,n);
+}
+
+template<std::size_t N>
+__attribute__((target("avx512f")))
+void kernel_avx512(float* out, const float* y, const std::array<const float*,N>& k, const std::array<float,N>& c, std::size_t n)
+{
+	__m512 vc[N];
+	for (std::size_t j = 0; j<N; ++j) vc[j] = _mm512_set1_ps(c[j]);
+	std::size_t i = 0;
+	for (; i+16<=n; i+=16)
+	{
+		__m512 acc = _mm512_loadu_ps(y+i);
+		for (std::size_t j = 0; j<N; ++j) acc = _mm512_fmadd_ps(vc[j],_mm512_loadu_ps(k[j]+i),acc);
+		_mm512_storeu_ps(out+i,acc);
+	}
+	kernel_generic(out,y,k,c,i,n);
+}
+#endif
+
+/* \brief out[i] = y[i] + sum_j c[j]*k[j][i], dispatched to the best kernel for this processor. out may alias y.
+ */
+template<typename T, std::size_t N>
+void axpy(T* out, const T* y, const std::array<const T*,N>& k, const std::array<T,N>& c, std::size_t n)
+{
+#ifdef IVP_FUSED_X86
+	switch (isa())
+	{
+		case Isa::avx512: kernel_avx512(out,y,k,c,n); return;
+		case Isa::avx2:   kernel_avx2(out,y,k,c,n);   return;
+		default: break;
+	}
+#endif
+	kernel_generic(out,y,k,c,0,n);
+}
+
+template<typename T>
+struct is_kernel_scalar : std::integral_constant<bool, std::is_same<T,float>::value || std::is_same<T,double>::value> { };
+
+template<typename T, std::size_t N>
+std::array<T,N> coefficients(const double (&c)[N])
+{
+	std::array<T,N> sol;
+	for (std::size_t j = 0; j<N; ++j) sol[j] = T(c[j]);
+	return sol;
+}
+
+template<typename Y, std::size_t N, std::size_t... I>
+Y chained(const Y& y, const double (&c)[N], const std::array<const Y*,N>& k, std::index_sequence<I...>)
+{
+	return (y + ... + (c[I]*(*k[I])));
+}
+
+}; //namespace fused
+
+}; //namespace IVP
+
+#endif
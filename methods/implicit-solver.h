@@ -0,0 +1,271 @@
+#ifndef _IVP_IMPLICIT_SOLVER_H_
+#define _IVP_IMPLICIT_SOLVER_H_
+
+#include "state.h"
+#include "jacobian.h"
+#include "dense.h"
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+
+namespace IVP {
+
+/* \brief Policies that solve the implicit equation of a step
+ *     y = c + a*f(t,y)
+ * starting at a guess, until two iterates differ less than tolerance. Implicit methods take one as a template
+ * parameter.
+ */
+
+/* \brief Thrown by the Newton policies when the Jacobian of the step is singular or the iteration does not
+ * converge within its maximum number of iterations (usually, the step is too large for the problem).
+ */
+class ImplicitSolverError : public std::runtime_error
+{
+public:
+	ImplicitSolverError(const std::string& what) : std::runtime_error(what) { }
+};
+
+/* Iterates y <- c + a*f(t,y). Cheap, but it only converges when a*df/dy is contractive (non stiff problems). */
+class FixedPointIteration
+{
+	unsigned int max_iterations;
+public:
+	FixedPointIteration(unsigned int _max_iterations = 10000) : max_iterations(_max_iterations) { }
+
+	template<typename Function, typename real, typename YType>
+	YType solve(const Function& f, const real& t, const YType& c, const real& a, const YType& guess, double tolerance) const
+	{
+		unsigned int i = 0;
+		YType y_i = guess;
+		YType y_i1 = c + a*f(t,y_i);
+		while ((real(state_traits<YType>::norm(y_i1 - y_i))>real(tolerance)) && (i<max_iterations))
+		{
+			y_i = y_i1; y_i1 = c + a*f(t,y_i); i++;
+		}
+		return y_i1;
+	}
+};
+
+/* Simplified Newton: the Jacobian (by default, exact through dual numbers) is evaluated and factored once per
+ * step at the guess, and reused by all the iterations. Throws ImplicitSolverError if it is singular or if the
+ * iterations do not converge.
+ */
+template<typename Jacobian = DualJacobian<>>
+class NewtonIteration
+{
+	unsigned int max_iterations;
+	Jacobian jacobian;
+public:
+	NewtonIteration(unsigned int _max_iterations = 20, const Jacobian& _jacobian = Jacobian()) :
+		max_iterations(_max_iterations), jacobian(_jacobian) { }
+
+	template<typename Function, typename real, typename YType>
+	YType solve(const Function& f, const real& t, const YType& c, const real& a, const YType& guess, double tolerance) const
+	{
+		using T = typename state_traits<YType>::value_type;
+		YType y = guess;
+		std::size_t n = state_traits<YType>::size(y);
+
+		DenseMatrix<T> m = jacobian(f,t,y);
+		for (std::size_t i = 0; i<n; ++i)
+		{
+			for (std::size_t j = 0; j<n; ++j) m(i,j) = -T(a)*m(i,j);
+			m(i,i) += T(1);
+		}
+		DenseLU<T> lu(m);
+		if (lu.singular()) throw ImplicitSolverError("NewtonIteration: singular Jacobian");
+
+		std::vector<T> delta(n);
+		for (unsigned int it = 0; ; ++it)
+		{
+			if (it == max_iterations) throw ImplicitSolverError("NewtonIteration: no convergence");
+			YType residual = y - c - a*f(t,y);
+			for (std::size_t i = 0; i<n; ++i) delta[i] = state_traits<YType>::at(residual,i);
+			lu.solve(delta);
+			T change(0);
+			for (std::size_t i = 0; i<n; ++i)
+			{
+				state_traits<YType>::at(y,i) -= delta[i];
+				if (!(std::abs(delta[i]) <= change)) change = std::abs(delta[i]); //NaN never converges
+			}
+			if (real(change) <= real(tolerance)) break;
+		}
+		return y;
+	}
+};
+
+/* \brief Preconditioners for NewtonKrylovIteration. prepare(f,t,y,a) is called once per Newton iteration and
+ * returns what applies an approximation of (I - a*df/dy)^-1, in place, to a std::vector of the value_type:
+ *     auto p = preconditioner.prepare(f,t,y,a);
+ *     p(v);
+ */
+class IdentityPreconditioner
+{
+public:
+	struct Apply
+	{
+		template<typename T>
+		void operator()(std::vector<T>& v) const { }
+	};
+
+	template<typename Function, typename real, typename YType>
+	Apply prepare(const Function& f, const real& t, const YType& y, const real& a) const { return Apply(); }
+};
+
+/* (I - a*D)^-1, D being the diagonal of df/dy that diagonal(t,y) returns as a YType */
+template<typename Diagonal>
+class DiagonalPreconditioner
+{
+	Diagonal diagonal;
+public:
+	DiagonalPreconditioner(const Diagonal& _diagonal = Diagonal()) : diagonal(_diagonal) { }
+
+	template<typename T>
+	struct Apply
+	{
+		std::vector<T> inverse;
+		void operator()(std::vector<T>& v) const { for (std::size_t i = 0; i<v.size(); ++i) v[i] *= inverse[i]; }
+	};
+
+	template<typename Function, typename real, typename YType>
+	Apply<typename state_traits<YType>::value_type> prepare(const Function& f, const real& t, const YType& y, const real& a) const
+	{
+		using T = typename state_traits<YType>::value_type;
+		YType d = diagonal(t,y);
+		Apply<T> sol; sol.inverse.resize(state_traits<YType>::size(d));
+		for (std::size_t i = 0; i<sol.inverse.size(); ++i) sol.inverse[i] = T(1)/(T(1) - T(a)*state_traits<YType>::at(d,i));
+		return sol;
+	}
+};
+
+template<typename Diagonal>
+DiagonalPreconditioner<Diagonal> diagonal_preconditioner(const Diagonal& diagonal)
+{	return DiagonalPreconditioner<Diagonal>(diagonal); }
+
+/* Jacobian-free Newton-Krylov, for systems too large for a Jacobian: each Newton iteration solves
+ * (I - a*df/dy)*delta = -residual with restarted GMRES, right preconditioned, to a relative residual of forcing.
+ * The products with df/dy are directional differences of f,
+ *     df/dy*v ~ (f(t,y + e*v) - f(t,y))/e,   e = sqrt(epsilon)*(1 + |y|)/|v|
+ * so each GMRES iteration costs an evaluation of f, and memory is restart + 1 Krylov vectors (and a few states).
+ * Throws ImplicitSolverError if the Newton iterations do not converge.
+ */
+template<typename Preconditioner = IdentityPreconditioner>
+class NewtonKrylovIteration
+{
+	unsigned int max_iterations, restart, max_restarts;
+	double forcing;
+	Preconditioner preconditioner;
+
+	template<typename T>
+	static T dot(const std::vector<T>& a, const std::vector<T>& b)
+	{	T s(0); for (std::size_t i = 0; i<a.size(); ++i) s += a[i]*b[i]; return s; }
+
+	/* x such that product(x) ~ b, from x = 0 */
+	template<typename T, typename Product, typename Apply>
+	void gmres(const Product& product, const Apply& precondition, const std::vector<T>& b, std::vector<T>& x) const
+	{
+		const std::size_t n = b.size(), m = restart;
+		std::vector<std::vector<T>> v(m + 1,std::vector<T>(n));
+		std::vector<T> h((m + 1)*m), cs(m), sn(m), g(m + 1), w(n), z(n);
+		std::fill(x.begin(),x.end(),T(0));
+		const T target = T(forcing)*std::sqrt(dot(b,b));
+		std::vector<T>& r = v[0];
+		r = b;
+		for (unsigned int cycle = 0; cycle<=max_restarts; ++cycle)
+		{
+			if (cycle > 0) { product(x,w); for (std::size_t i = 0; i<n; ++i) r[i] = b[i] - w[i]; }
+			T beta = std::sqrt(dot(r,r));
+			if (!(beta > target)) return;
+			for (std::size_t i = 0; i<n; ++i) r[i] /= beta;
+			std::fill(g.begin(),g.end(),T(0)); g[0] = beta;
+
+			std::size_t k = 0;
+			for (std::size_t j = 0; j<m; ++j)
+			{
+				z = v[j]; precondition(z);
+				product(z,w);
+				for (std::size_t i = 0; i<=j; ++i)
+				{
+					T hij = h[i*m + j] = dot(w,v[i]);
+					for (std::size_t l = 0; l<n; ++l) w[l] -= hij*v[i][l];
+				}
+				T hj1 = std::sqrt(dot(w,w));
+				for (std::size_t i = 0; i<j; ++i)
+				{
+					T a = h[i*m + j], b2 = h[(i + 1)*m + j];
+					h[i*m + j] = cs[i]*a + sn[i]*b2; h[(i + 1)*m + j] = -sn[i]*a + cs[i]*b2;
+				}
+				T d = std::sqrt(h[j*m + j]*h[j*m + j] + hj1*hj1);
+				cs[j] = (d > T(0))?h[j*m + j]/d:T(1); sn[j] = (d > T(0))?hj1/d:T(0);
+				h[j*m + j] = d; g[j + 1] = -sn[j]*g[j]; g[j] = cs[j]*g[j];
+				k = j + 1;
+				if (hj1 > T(0) && (j + 1<m)) for (std::size_t l = 0; l<n; ++l) v[j + 1][l] = w[l]/hj1;
+				if (!(std::abs(g[j + 1]) > target) || !(hj1 > T(0))) break;
+			}
+
+			for (std::size_t i = k; i-->0; )
+			{
+				for (std::size_t j = i + 1; j<k; ++j) g[i] -= h[i*m + j]*g[j];
+				g[i] = (h[i*m + i] != T(0))?g[i]/h[i*m + i]:T(0);
+			}
+			std::fill(z.begin(),z.end(),T(0));
+			for (std::size_t i = 0; i<k; ++i) for (std::size_t l = 0; l<n; ++l) z[l] += g[i]*v[i][l];
+			precondition(z);
+			for (std::size_t l = 0; l<n; ++l) x[l] += z[l];
+		}
+	}
+
+public:
+	NewtonKrylovIteration(unsigned int _max_iterations = 20, unsigned int _restart = 30, double _forcing = 1.e-3,
+		unsigned int _max_restarts = 10, const Preconditioner& _preconditioner = Preconditioner()) :
+		max_iterations(_max_iterations), restart(std::max(_restart,1u)), max_restarts(_max_restarts), forcing(_forcing),
+		preconditioner(_preconditioner) { }
+
+	template<typename Function, typename real, typename YType>
+	YType solve(const Function& f, const real& t, const YType& c, const real& a, const YType& guess, double tolerance) const
+	{
+		using T = typename state_traits<YType>::value_type;
+		using traits = state_traits<YType>;
+		YType y = guess;
+		std::size_t n = traits::size(y);
+		std::vector<T> b(n), delta(n);
+		for (unsigned int it = 0; ; ++it)
+		{
+			if (it == max_iterations) throw ImplicitSolverError("NewtonKrylovIteration: no convergence");
+			YType f_y = f(t,y);
+			YType residual = y - c - a*f_y;
+			for (std::size_t i = 0; i<n; ++i) b[i] = -traits::at(residual,i);
+			T norm_y(0);
+			for (std::size_t i = 0; i<n; ++i) norm_y += traits::at(y,i)*traits::at(y,i);
+			norm_y = std::sqrt(norm_y);
+
+			//(I - a*df/dy)*v
+			YType y_v = y;
+			auto product = [&] (const std::vector<T>& v, std::vector<T>& out)
+			{
+				T norm_v = std::sqrt(dot(v,v));
+				if (norm_v == T(0)) { std::fill(out.begin(),out.end(),T(0)); return; }
+				T e = std::sqrt(std::numeric_limits<T>::epsilon())*(T(1) + norm_y)/norm_v;
+				for (std::size_t i = 0; i<n; ++i) traits::at(y_v,i) = traits::at(y,i) + e*v[i];
+				YType f_v = f(t,y_v);
+				for (std::size_t i = 0; i<n; ++i) out[i] = v[i] - T(a)*(traits::at(f_v,i) - traits::at(f_y,i))/e;
+			};
+			gmres(product,preconditioner.prepare(f,t,y,a),b,delta);
+
+			T change(0);
+			for (std::size_t i = 0; i<n; ++i)
+			{
+				traits::at(y,i) += delta[i];
+				if (!(std::abs(delta[i]) <= change)) change = std::abs(delta[i]); //NaN never converges
+			}
+			if (real(change) <= real(tolerance)) break;
+		}
+		return y;
+	}
+};
+
+}; //namespace IVP
+
+#endif
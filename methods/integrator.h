@@ -0,0 +1,93 @@
+#ifndef _IVP_INTEGRATOR_H_
+#define _IVP_INTEGRATOR_H_
+
+#include "method.h"
+#include "state.h"
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <type_traits>
+
+namespace IVP {
+
+/* \brief An integration from t_ini to t_end that is advanced on demand, i.e. by the time slices of a
+ * co-simulation.
+ *
+ * The method takes its natural steps across calls, as it would in a single solve: the adapted step size and the
+ * data between steps (FSAL evaluations, extrapolation columns...) carry over, and only the very last step is
+ * shortened to end at t_end. advance_to(t) steps until it reaches or passes t, and interpolates the state at t
+ * (cubic Hermite on the step that contains t, which takes up to two evaluations of f per step where that
+ * happens, reused by the next requests within the same step).
+ *
+ * Times must increase from t_ini to t_end, and requests can not go back before the last step taken.
+ */
+template<typename M, typename YType, typename Function, typename real = double>
+class Integrator
+{
+	using Steps = decltype(std::declval<const M&>().steps(std::declval<const Function&>(),real(),std::declval<const YType&>(),real()));
+	using StepData = typename M::template StepData<YType,real>;
+
+	struct State
+	{
+		M m; Function f;
+		real t_end;
+		Steps steps;
+		typename Steps::const_iterator current, end;
+		real t_previous; YType y_previous;      //Start of the current step
+		YType f_previous, f_current; bool has_f_previous, has_f_current;
+		std::size_t steps_taken;
+
+		State(const M& _m, const Function& _f, const real& t_ini, const YType& y_ini, const real& _t_end) :
+			m(_m), f(_f), t_end(_t_end), steps(m.steps(f,t_ini,y_ini,t_end)), current(steps.begin()), end(steps.end()),
+			t_previous(t_ini), y_previous(y_ini), has_f_previous(false), has_f_current(false), steps_taken(0) { }
+	};
+
+	std::unique_ptr<State> state;
+public:
+	Integrator(const M& m, const Function& f, const real& t_ini, const YType& y_ini, const real& t_end) :
+		state(new State(m,f,t_ini,y_ini,t_end)) { }
+
+	/* Where the method is, which can be ahead of the last time requested */
+	const real& t()             const { return (*state->current).t(); }
+	const YType& y()            const { return (*state->current).y(); }
+	const real& step()          const { return (*state->current).step(); }
+	const real& t_end()         const { return state->t_end; }
+	std::size_t steps_taken()   const { return state->steps_taken; }
+
+	/* \brief State at t, stepping as far as needed. Throws std::invalid_argument if t is after t_end or before
+	 * the start of the last step. If a step throws, the steps completed before it are kept.
+	 */
+	YType advance_to(const real& t)
+	{
+		State& s = *state;
+		if ((t > s.t_end) || (t < s.t_previous)) throw std::invalid_argument("Integrator::advance_to out of the current step or after t_end");
+		while (((*s.current).t() < t) && (s.current != s.end))
+		{
+			//The step is taken on a copy: if it throws, the integrator stays at the last complete step (with the
+			//step size that the abandoned one got to, so that it does not go through the same rejections again)
+			typename Steps::const_iterator next = s.current;
+			try { ++next; }
+			catch (...) { s.current.keep_step(next); throw; }
+			s.t_previous = (*s.current).t(); s.y_previous = (*s.current).y();
+			std::swap(s.f_previous,s.f_current);
+			s.has_f_previous = s.has_f_current; s.has_f_current = false;
+			s.current = std::move(next); ++s.steps_taken;
+		}
+
+		const StepData& c = *s.current;
+		if ((t == c.t()) || (s.current == s.end)) return c.y(); //The latter, if the last step fell short of t_end by rounding
+		if (t == s.t_previous) return s.y_previous;
+		if (!s.has_f_previous) { s.f_previous = s.f(s.t_previous,s.y_previous); s.has_f_previous = true; }
+		if (!s.has_f_current)  { s.f_current  = s.f(c.t(),c.y());               s.has_f_current  = true; }
+		real h = c.t() - s.t_previous;
+		return hermite(double((t - s.t_previous)/h),double(h),s.y_previous,s.f_previous,c.y(),s.f_current);
+	}
+};
+
+template<typename M, typename YType, typename Function, typename real>
+Integrator<M,YType,std::decay_t<Function>,real> integrator(const M& m, const Function& f, const real& t_ini, const YType& y_ini, const real& t_end)
+{	return Integrator<M,YType,std::decay_t<Function>,real>(m,f,t_ini,y_ini,t_end); }
+
+}; //namespace IVP
+
+#endif
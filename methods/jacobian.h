@@ -0,0 +1,76 @@
+#ifndef _IVP_JACOBIAN_H_
+#define _IVP_JACOBIAN_H_
+
+#include "state.h"
+#include "dual.h"
+#include "dense.h"
+#include <algorithm>
+#include <limits>
+
+namespace IVP {
+
+/* \brief Exact Jacobian df/dy by forward automatic differentiation.
+ *
+ * f is evaluated on Dual values, seeding Chunk columns at a time, so it takes n/Chunk evaluations. f must be
+ * templated on its state (generic lambdas or template operator()) and YType needs state_traits rebind and cast.
+ * The default chunk is a 512 bit register of doubles.
+ */
+template<std::size_t Chunk = 8>
+class DualJacobian
+{
+public:
+	template<typename Function, typename real, typename YType>
+	DenseMatrix<typename state_traits<YType>::value_type> operator()(const Function& f, const real& t, const YType& y) const
+	{
+		using T = typename state_traits<YType>::value_type;
+		using D = Dual<T,Chunk>;
+		using DYType = typename state_traits<YType>::template rebind<D>;
+
+		std::size_t n = state_traits<YType>::size(y);
+		DenseMatrix<T> sol(n,n);
+		DYType yd = state_traits<YType>::template cast<D>(y);
+		for (std::size_t start = 0; start<n; start += Chunk)
+		{
+			std::size_t width = std::min(Chunk,n - start);
+			for (std::size_t k = 0; k<width; ++k) state_traits<DYType>::at(yd,start+k).d[k] = T(1);
+			DYType fd = f(t,yd);
+			for (std::size_t i = 0; i<n; ++i)
+			{
+				const D& fi = state_traits<DYType>::at(fd,i);
+				for (std::size_t k = 0; k<width; ++k) sol(i,start+k) = fi.d[k];
+			}
+			for (std::size_t k = 0; k<width; ++k) state_traits<DYType>::at(yd,start+k).d[k] = T(0);
+		}
+		return sol;
+	}
+};
+
+/* \brief Jacobian df/dy by forward finite differences (n+1 evaluations of f). Works with any f. */
+class FiniteDifferenceJacobian
+{
+public:
+	template<typename Function, typename real, typename YType>
+	DenseMatrix<typename state_traits<YType>::value_type> operator()(const Function& f, const real& t, const YType& y) const
+	{
+		using T = typename state_traits<YType>::value_type;
+		std::size_t n = state_traits<YType>::size(y);
+		DenseMatrix<T> sol(n,n);
+		YType f0 = f(t,y);
+		YType yj = y;
+		for (std::size_t j = 0; j<n; ++j)
+		{
+			T yj0 = state_traits<YType>::at(y,j);
+			T delta = std::sqrt(std::numeric_limits<T>::epsilon())*std::max(T(1),std::abs(yj0));
+			state_traits<YType>::at(yj,j) = yj0 + delta;
+			delta = state_traits<YType>::at(yj,j) - yj0; //Exactly representable
+			YType fj = f(t,yj);
+			for (std::size_t i = 0; i<n; ++i) sol(i,j) = (state_traits<YType>::at(fj,i) - state_traits<YType>::at(f0,i))/delta;
+			state_traits<YType>::at(yj,j) = yj0;
+		}
+		return sol;
+	}
+};
+
+}; //namespace IVP
+
+#endif
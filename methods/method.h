@@ -1,8 +1,12 @@
 #ifndef _IVP_METHOD_H_
 #define _IVP_METHOD_H_
 
+#include "state.h"
+#include "trace.h"
 #include <cmath>
 #include <functional>
+#include <type_traits>
+#include <utility>
 
 namespace IVP {
 
@@ -57,18 +61,18 @@ auto wrapped_between_steps_first(const M& m, const Function& f, const real& ini,
 
 template<typename M>
 class Method {
-	float h;
+	double h;
 	unsigned int nsteps;
 public:
-	Method(float s) :   h(s),nsteps(0) { }
-	Method(unsigned int ns) : h(-1.0f),nsteps(ns) { }
+	Method(double s) :   h(s),nsteps(0) { }
+	Method(unsigned int ns) : h(-1.0),nsteps(ns) { }
 
 	static const bool is_embedded = false;
 	static const bool data_between_steps = false;
 
-	int expected_steps()                  const { return nsteps>0?nsteps:int(1.0f/h); }
+	int expected_steps()                  const { return nsteps>0?nsteps:int(1.0/h); }
 	template<typename real>
-	real step(const real& total) const { return nsteps>0?(total/real(nsteps)):h; }
+	real step(const real& total) const { return nsteps>0?(total/real(nsteps)):real(h); }
 
 
 protected:
@@ -78,14 +82,8 @@ protected:
 	static double norm(double t) { return std::fabs(t); }
 
 	template<typename V>
-	static typename V::value_type norm(const V& v) 
-	{
-		typename V::value_type sol(0.0);
-		typename V::const_iterator i;
-		for (i = v.begin(); i != v.end(); i++) 
-			if (sol < real(*i)) sol=real(*i);
-		return sol;
-	}
+	static typename state_traits<V>::value_type norm(const V& v) 
+	{	return state_traits<V>::norm(v);	}
 
 public:
 	/* \brief Indicates which information is passed between steps (apart from the standard one).
@@ -108,8 +106,8 @@ public:
 		real   _step;
 		real next_t()	    const { return t() + step(); }
 	public:
-		StepData(const YType& y = YType(), const real& t = real(), const real& step = real()) :
-			_y(y), _t(t), _step(step) { }
+		StepData(YType y = YType(), const real& t = real(), const real& step = real()) :
+			_y(std::move(y)), _t(t), _step(step) { }
 		const YType& y()    const { return _y; }
 		const real& t()     const { return _t; }
 		const real& step()  const { return _step; }
@@ -133,42 +131,61 @@ public:
 		real  t_ini, t_end;
 		BetweenSteps bs_ini;
 	public:
-		Steps(const M& _m, const Function& _f, const real& _t_ini, const YType& _y_ini, const real& _t_end) :
-			m(_m), f(_f), y_ini(_y_ini), t_ini(_t_ini), t_end(_t_end), 
-//				bs_ini(m.between_steps_first(_f,_t_ini,_y_ini,_t_end)) { }
-				bs_ini(wrapped_between_steps_first(m,_f,_t_ini,_y_ini,_t_end)) { }
+		template<typename F, typename Y>
+		Steps(const M& _m, F&& _f, const real& _t_ini, Y&& _y_ini, const real& _t_end) :
+			m(_m), f(std::forward<F>(_f)), y_ini(std::forward<Y>(_y_ini)), t_ini(_t_ini), t_end(_t_end), 
+//				bs_ini(m.between_steps_first(f,t_ini,y_ini,t_end)) { }
+				bs_ini(wrapped_between_steps_first(m,f,t_ini,y_ini,t_end)) { }
 
 		class const_iterator : public ConstIteratorFacade<const_iterator>
 		{
 			friend class Steps<YType,Function, real>;
 			StepData<YType,real> step_data;
 			BetweenSteps bs;
-			const Steps& steps; bool done;
+			const Steps* steps; bool done;  //A pointer, so that iterators can be assigned
 			const_iterator(const real& step, const Steps& _steps) : 
-				step_data(_steps.y_ini,_steps.t_ini,step),bs(_steps.bs_ini),steps(_steps),done(false) { }
-			const_iterator(const Steps& _steps) : steps(_steps),done(true) { }
+				step_data(_steps.y_ini,_steps.t_ini,step),bs(_steps.bs_ini),steps(&_steps),done(false) { }
+			const_iterator(const real& step, YType&& y, BetweenSteps&& _bs, const Steps& _steps) : 
+				step_data(std::move(y),_steps.t_ini,step),bs(std::move(_bs)),steps(&_steps),done(false) { }
+			const_iterator(const Steps& _steps) : steps(&_steps),done(true) { }
 		public:
 			void inc() 
 			{ 
-			   if (step_data.is_last(steps.t_end)) done = true;
+			   if (step_data.is_last(steps->t_end)) done = true;
 			   else {
-			      if (step_data.is_pre_last(steps.t_end)) step_data.step() = steps.t_end - step_data.t();
-                              step_data.t() = steps.m.next(steps.f, step_data.t(), step_data.y(), step_data.step(), bs); 
+			      if (step_data.is_pre_last(steps->t_end)) step_data.step() = steps->t_end - step_data.t();
+			      IVP_TRACE_SCOPE(trace_step, "step", step_data.t(), step_data.step());
+                              step_data.t() = steps->m.next(steps->f, step_data.t(), step_data.y(), step_data.step(), bs); 
+			      IVP_TRACE_END_AT(trace_step, step_data.t());
 			   }
 			}
 			bool equals(const const_iterator& that) const 
 			{       return (this->done == that.done); }
 			const StepData<YType,real>& operator*() const { return step_data; } 		
+			/* Takes the step size of a copy whose step was abandoned (by an exception), which may have been reduced by rejections */
+			void keep_step(const const_iterator& that) { step_data.step() = that.step_data.step(); }
 		};
 
 		const_iterator begin() const { return const_iterator(m.step(t_end - t_ini), *this);  }
 		const_iterator end()   const { return const_iterator(*this); }
+
+		/* \brief Takes all the steps and returns the last state, without copying it: y_ini is moved into the
+		 * iteration, so these Steps can not be iterated again.
+		 */
+		YType run() &&
+		{
+			const_iterator it(m.step(t_end - t_ini), std::move(y_ini), std::move(bs_ini), *this);
+			while (!it.done) it.inc();
+			return std::move(it.step_data.y());
+		}
 	};
 public:
+	/* f and y_ini are kept in the Steps: moved if they are rvalues, copied otherwise */
 	template<typename YType, typename Function, typename real>
-	Steps<YType, Function, real> steps(const Function& f, const real& t_ini, const YType& y_ini, const real& t_end) const
+	Steps<std::decay_t<YType>, std::decay_t<Function>, real> steps(Function&& f, const real& t_ini, YType&& y_ini, const real& t_end) const
 	{
-		return Steps<YType, Function, real>(static_cast<const M&>(*this),f,t_ini,y_ini,t_end);
+		return Steps<std::decay_t<YType>, std::decay_t<Function>, real>(static_cast<const M&>(*this),
+			std::forward<Function>(f),t_ini,std::forward<YType>(y_ini),t_end);
 	}
 
 private:
@@ -194,22 +211,22 @@ public:
 		return steps(VariableChangedFunction<Function,VChange,DVChange>(f,vc,dvc), vc_inv(t_ini),y_ini, vc_inv(t_end));
 	}
 
+	/* The state is copied once (not at all if y_a is an rvalue), and not at every step */
 	template<typename YType, typename Function, typename real>
-	YType solve(const Function& f, real a, const YType& y_a, real b) const
-	{
-		YType y = y_a;
-		for (auto s : steps(f,a,y_a,b)) { y = s.y(); }
-		return y;
-	}
+	std::decay_t<YType> solve(Function&& f, real a, YType&& y_a, real b) const
+	{	return steps(std::forward<Function>(f),a,std::forward<YType>(y_a),b).run(); }
+
+	/* Solves from y at a, leaving in y the solution at b */
+	template<typename YType, typename Function, typename real>
+	void solve_inplace(const Function& f, real a, YType& y, real b) const
+	{	y = steps(f,a,std::move(y),b).run(); }
 
 
 	template<typename YType, typename Function, typename real, typename VChange, typename InvVChange, typename DInvVChange>
 	YType solve_change_of_variable(const Function& f, real a, const YType& y_a, real b,
 		const VChange& vc, const InvVChange& vc_inv, const DInvVChange& d_inv_vc) const
 	{
-		YType y = y_a;
-		for (auto s : steps_change_of_variable(f,a,y_a,b,vc,vc_inv, d_inv_vc)) { y = s.y(); }
-		return y;
+		return steps_change_of_variable(f,a,y_a,b,vc,vc_inv, d_inv_vc).run();
 	}
 
 };
@@ -223,36 +240,51 @@ class Method<M>::Steps<YType,Function,real,void> {
 	YType y_ini; 
 	real  t_ini, t_end;
 public:
-	Steps(const M& _m, const Function& _f, const real& _t_ini, const YType& _y_ini, const real& _t_end) :
-		m(_m), f(_f), y_ini(_y_ini), t_ini(_t_ini), t_end(_t_end) { }
+	template<typename F, typename Y>
+	Steps(const M& _m, F&& _f, const real& _t_ini, Y&& _y_ini, const real& _t_end) :
+		m(_m), f(std::forward<F>(_f)), y_ini(std::forward<Y>(_y_ini)), t_ini(_t_ini), t_end(_t_end) { }
 
 	class const_iterator : public ConstIteratorFacade<const_iterator>
 	{
 		friend class Steps<YType,Function, real>;
 		Method<M>::StepData<YType,real> step_data;
-		const Steps& steps; bool done;
+		const Steps* steps; bool done;  //A pointer, so that iterators can be assigned
 		const_iterator(const real& step, const Steps& _steps) : 
-			step_data(_steps.y_ini,_steps.t_ini,step),steps(_steps),done(false) { }
-		const_iterator(const Steps& _steps) : steps(_steps),done(true) { }
+			step_data(_steps.y_ini,_steps.t_ini,step),steps(&_steps),done(false) { }
+		const_iterator(const real& step, YType&& y, const Steps& _steps) : 
+			step_data(std::move(y),_steps.t_ini,step),steps(&_steps),done(false) { }
+		const_iterator(const Steps& _steps) : steps(&_steps),done(true) { }
 	public:
 		void inc() 
 		{ 
-		   if (step_data.is_last(steps.t_end)) done = true;
+		   if (step_data.is_last(steps->t_end)) done = true;
 		   else {
-		      if (step_data.is_pre_last(steps.t_end)) step_data.step() = steps.t_end - step_data.t();
-                      step_data.t() = steps.m.next(steps.f, step_data.t(), step_data.y(), step_data.step()); 
+		      if (step_data.is_pre_last(steps->t_end)) step_data.step() = steps->t_end - step_data.t();
+		      IVP_TRACE_SCOPE(trace_step, "step", step_data.t(), step_data.step());
+                      step_data.t() = steps->m.next(steps->f, step_data.t(), step_data.y(), step_data.step()); 
+		      IVP_TRACE_END_AT(trace_step, step_data.t());
 		   }
 		}
 		bool equals(const const_iterator& that) const 
 		{       return (this->done == that.done); }
 		const Method<M>::StepData<YType,real>& operator*() const { return step_data; } 		
+		/* Takes the step size of a copy whose step was abandoned (by an exception), which may have been reduced by rejections */
+		void keep_step(const const_iterator& that) { step_data.step() = that.step_data.step(); }
 	};
 
 
 	const_iterator begin() const { return const_iterator(m.step(t_end - t_ini), *this);  }
 	const_iterator end()   const { return const_iterator(*this); }
 
-
+	/* \brief Takes all the steps and returns the last state, without copying it: y_ini is moved into the
+	 * iteration, so these Steps can not be iterated again.
+	 */
+	YType run() &&
+	{
+		const_iterator it(m.step(t_end - t_ini), std::move(y_ini), *this);
+		while (!it.done) it.inc();
+		return std::move(it.step_data.y());
+	}
 };
 
 template<typename M>
@@ -263,7 +295,7 @@ public:
 
 //	The next line is for gcc 4.8
 //      using Method<MethodEmbedded<M>>::Method<MethodEmbedded<M>>;
-	MethodEmbedded(float s) :   Method<MethodEmbedded<M>>(s)  { }
+	MethodEmbedded(double s) :   Method<MethodEmbedded<M>>(s)  { }
 	MethodEmbedded(unsigned int ns = 1) : Method<MethodEmbedded<M>>(ns) { }
 
 	template<typename YType, typename Function, typename real>  
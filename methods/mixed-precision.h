@@ -0,0 +1,150 @@
+#ifndef _IVP_MIXED_PRECISION_H_
+#define _IVP_MIXED_PRECISION_H_
+
+#include "method.h"
+#include "state.h"
+
+namespace IVP {
+
+/* \brief f around the state at the beginning of a step, in low precision: g(tau, z) = f(t + tau, y + z).
+ *
+ * The deviation z is small, so its relative rounding error does not pile up on y step after step. Time is not:
+ * t + tau stays in the precision of the problem, so f does not see float times (whose resolution at large t
+ * could be coarser than the step). Only the state is Low.
+ */
+template<typename Function, typename LowYType, typename Low, typename real>
+class DeviationFunction
+{
+	const Function& f; real t; LowYType y;
+public:
+	DeviationFunction(const Function& _f, const real& _t, const LowYType& _y) : f(_f), t(_t), y(_y) { }
+	LowYType operator()(const Low& tau, const LowYType& z) const { return f(t + real(tau), y + z); }
+	LowYType zero() const { return y - y; }
+};
+
+template<typename YType, typename real, typename BaseBetweenSteps>
+struct MixedPrecisionData
+{
+	YType compensation; real t_compensation;
+	BaseBetweenSteps base;
+};
+
+template<typename YType, typename real>
+struct MixedPrecisionData<YType,real,void>
+{
+	YType compensation; real t_compensation;
+};
+
+/* \brief Runs the stages of BaseMethod in Low precision (float by default), and accumulates y and t in the
+ *        precision of the problem.
+ *
+ * Each step integrates the deviation from the current state with BaseMethod in Low precision (stage evaluations,
+ * k vectors, fused combinations), so the cheap and bandwidth-hungry part runs at float speed. The deviation is
+ * then added to y in full precision. When the steps are iterated directly, that sum (and the sum of times) is
+ * compensated (Kahan). Under Adaptive it is a plain sum, as rejected steps would spoil the compensation.
+ *
+ * YType needs state_traits<YType>::rebind and cast (see state.h).
+ */
+template<typename BaseMethod, typename Low = float>
+class MixedPrecision : public Method<MixedPrecision<BaseMethod,Low>>
+{
+	BaseMethod _base_method;
+
+	template<typename YType>
+	using LowYType = typename state_traits<YType>::template rebind<Low>;
+	template<typename YType, typename Function, typename real>
+	using Deviation = DeviationFunction<Function,LowYType<YType>,Low,real>;
+	template<typename YType, typename Function, typename real>
+	using BaseBetweenSteps = typename Type<BaseMethod,LowYType<YType>,Deviation<YType,Function,real>,Low>::BetweenSteps;
+	template<typename YType>
+	using Element = typename state_traits<YType>::value_type;
+
+public:
+	static const bool is_embedded = BaseMethod::is_embedded;
+
+	MixedPrecision(const BaseMethod& bm = BaseMethod()) : Method<MixedPrecision<BaseMethod,Low>>(1u), _base_method(bm) { }
+
+	const BaseMethod& base_method() const { return _base_method; }
+	int expected_steps()              const { return base_method().expected_steps(); }
+	template<typename real>
+	real step(const real& total)      const { return base_method().step(total); }
+
+	template<typename YType, typename Function, typename real>
+	MixedPrecisionData<YType,real,BaseBetweenSteps<YType,Function,real>>
+		between_steps_first(const Function& f, const real& t_ini, const YType& y_ini, const real& t_end) const
+	{
+		MixedPrecisionData<YType,real,BaseBetweenSteps<YType,Function,real>> data;
+		data.compensation = y_ini - y_ini; data.t_compensation = real(0);
+		base_between_steps_first(data,Deviation<YType,Function,real>(f,t_ini,precision_cast<Low>(y_ini)),Low(t_end - t_ini));
+		return data;
+	}
+
+	template<typename YType, typename Function, typename real, typename Data>
+	real next(const Function& f, const real& t, YType& y_t, real& ht, Data& data) const
+	{
+		Deviation<YType,Function,real> g(f,t,precision_cast<Low>(y_t));
+		LowYType<YType> z = g.zero(); Low h(ht);
+		base_next(g,z,h,data);
+		ht = real(h);
+
+		compensated_add(y_t,z,data.compensation);
+
+		real dt = ht - data.t_compensation;
+		real t_next = t + dt;
+		data.t_compensation = (t_next - t) - dt;
+		return t_next;
+	}
+
+	template<typename YType, typename Function, typename real, typename Data>
+	real next_embedded(const Function& f, real t, YType& y_t, real& ht, Data& data, YType& other) const
+	{
+		Deviation<YType,Function,real> g(f,t,precision_cast<Low>(y_t));
+		LowYType<YType> z = g.zero(); LowYType<YType> z_other; Low h(ht);
+		base_next_embedded(g,z,h,data,z_other);
+		ht = real(h);
+		other = y_t + precision_cast<Element<YType>>(z_other);
+		y_t   = y_t + precision_cast<Element<YType>>(z);
+		return t + ht;
+	}
+
+private:
+	//Kahan summation y += z, elementwise in a single pass
+	template<typename YType, typename Z>
+	static void compensated_add(YType& y, const Z& z, YType& compensation)
+	{
+		for (std::size_t i = 0; i<state_traits<YType>::size(y); ++i)
+		{
+			Element<YType> dy = Element<YType>(state_traits<Z>::at(z,i)) - state_traits<YType>::at(compensation,i);
+			Element<YType> y_next = state_traits<YType>::at(y,i) + dy;
+			state_traits<YType>::at(compensation,i) = (y_next - state_traits<YType>::at(y,i)) - dy;
+			state_traits<YType>::at(y,i) = y_next;
+		}
+	}
+
+	template<typename YType, typename real, typename G>
+	void base_between_steps_first(MixedPrecisionData<YType,real,void>& data, const G& g, const Low& t_end) const { }
+	template<typename YType, typename real, typename BS, typename G>
+	void base_between_steps_first(MixedPrecisionData<YType,real,BS>& data, const G& g, const Low& t_end) const
+	{	data.base = wrapped_between_steps_first(base_method(),g,Low(0),g.zero(),t_end); }
+
+	template<typename G, typename Z, typename YType, typename real>
+	void base_next(const G& g, Z& z, Low& h, MixedPrecisionData<YType,real,void>& data) const
+	{	base_method().next(g,Low(0),z,h); }
+	template<typename G, typename Z, typename YType, typename real, typename BS>
+	void base_next(const G& g, Z& z, Low& h, MixedPrecisionData<YType,real,BS>& data) const
+	{	base_method().next(g,Low(0),z,h,data.base); }
+
+	template<typename G, typename Z, typename YType, typename real>
+	void base_next_embedded(const G& g, Z& z, Low& h, MixedPrecisionData<YType,real,void>& data, Z& z_other) const
+	{	base_method().next_embedded(g,Low(0),z,h,z_other); }
+	template<typename G, typename Z, typename YType, typename real, typename BS>
+	void base_next_embedded(const G& g, Z& z, Low& h, MixedPrecisionData<YType,real,BS>& data, Z& z_other) const
+	{	base_method().next_embedded(g,Low(0),z,h,data.base,z_other); }
+};
+
+template<typename Low = float, typename BaseMethod>
+MixedPrecision<BaseMethod,Low> mixed_precision(const BaseMethod& bm) { return MixedPrecision<BaseMethod,Low>(bm); }
+
+}; //namespace IVP
+
+#endif
@@ -0,0 +1,244 @@
+#ifndef _IVP_MULTIPLE_SHOOTING_H_
+#define _IVP_MULTIPLE_SHOOTING_H_
+
+#include "state.h"
+#include "sensitivity.h"
+#include "jacobian.h"
+#include "dense.h"
+#include "thread-pool.h"
+#include <vector>
+#include <memory>
+#include <cmath>
+#include <algorithm>
+#include <type_traits>
+
+namespace IVP {
+
+/* \brief Variational equations of y' = f(t,y) on SensitivityState: S' = df/dy(t,y)*S, whose columns started at the
+ * identity give the derivative of the flow with respect to the initial state.
+ */
+template<typename Function, typename Jacobian>
+class VariationalProblem
+{
+public:
+	Function f; Jacobian jacobian;
+	VariationalProblem(const Function& _f, const Jacobian& _jacobian) : f(_f), jacobian(_jacobian) { }
+
+	template<typename real, typename YType>
+	SensitivityState<YType> operator()(const real& t, const SensitivityState<YType>& x) const
+	{
+		auto j = jacobian(f,t,x.y);
+		SensitivityState<YType> sol(f(t,x.y));
+		sol.s.reserve(x.s.size());
+		for (const YType& c : x.s) sol.s.push_back(j*c);
+		return sol;
+	}
+};
+
+/* \brief Nodes and states of a boundary value problem: y[k] at t[k], from a to b. */
+template<typename YType, typename real>
+struct BVPSolution
+{
+	std::vector<real> t; std::vector<YType> y;
+	unsigned int iterations; bool converged;
+	double residual;  //Largest mismatch at the nodes or of the boundary conditions
+};
+
+/**
+ * Multiple shooting for two point boundary value problems
+ *     y' = f(t,y),  bc(y(a),y(b)) = 0
+ * with n = size(y) conditions. [a,b] is split into segments at the nodes t_k, and Newton's method looks for the
+ * states s_k at the nodes such that every segment, integrated from s_k with the method M, ends at s_(k+1) and
+ * the boundary conditions hold. Each segment is as short as the instability of the problem needs (a single
+ * segment is single shooting, whose sensitivities grow like exp(L*(b - a))).
+ *
+ * Segments are integrated with their variational equations (VariationalProblem, the Jacobian of f by the
+ * Jacobian policy, as in NewtonIteration) and they are independent, so with a ThreadPool they are integrated
+ * concurrently. f must then be callable from several threads at once. The Jacobian of bc is taken by finite
+ * differences.
+ *
+ * The Newton system is block bidiagonal, plus the boundary conditions that couple the first and the last node:
+ *     G_k*dx_k - dx_(k+1) = -F_k          k = 0...m-2, G_k = d(segment k)/ds_k
+ *     B_a*dx_0 + B_b*G_(m-1)*dx_(m-1) = -F_(m-1)
+ * It is solved block by block (Gaussian elimination with partial pivoting within each pair of block rows), in
+ * O(m*n^3) time and O(m*n^2) memory. Newton steps that do not reduce the largest residual are halved, which
+ * costs an integration of all the segments each time. iterations counts the integrations.
+ */
+template<typename M, typename Jacobian = DualJacobian<>>
+class MultipleShooting
+{
+	M method;
+	unsigned int _segments;
+	double _tolerance;
+	unsigned int max_iterations;
+	std::shared_ptr<ThreadPool> pool;
+	Jacobian jacobian;
+
+	template<typename T>
+	static std::vector<std::vector<T>> solve_newton(const std::vector<DenseMatrix<T>>& g, const DenseMatrix<T>& ba,
+		const DenseMatrix<T>& bbg, const std::vector<std::vector<T>>& residual, std::size_t n)
+	{
+		std::size_t m = g.size();
+		//Remainder rows: C*x_k + E*x_(m-1) = r, as columns [C | E | r]
+		DenseMatrix<T> rest(n,2*n + 1);
+		for (std::size_t i = 0; i<n; ++i)
+		{
+			for (std::size_t j = 0; j<n; ++j) { rest(i,j) = ba(i,j); rest(i,n + j) = bbg(i,j); }
+			rest(i,2*n) = -residual[m - 1][i];
+		}
+		std::vector<DenseMatrix<T>> pivots; pivots.reserve(m);
+		for (std::size_t k = 0; k + 1<m; ++k)
+		{
+			//Columns [x_k | x_(k+1) | x_(m-1) | r]: the matching conditions of segment k over the remainder
+			DenseMatrix<T> panel(2*n,3*n + 1);
+			for (std::size_t i = 0; i<n; ++i)
+			{
+				for (std::size_t j = 0; j<n; ++j) panel(i,j) = g[k](i,j);
+				panel(i,n + i) = T(-1);
+				panel(i,3*n) = -residual[k][i];
+				for (std::size_t j = 0; j<n; ++j) { panel(n + i,j) = rest(i,j); panel(n + i,2*n + j) = rest(i,n + j); }
+				panel(n + i,3*n) = rest(i,2*n);
+			}
+			for (std::size_t c = 0; c<n; ++c)
+			{
+				std::size_t p = c;
+				for (std::size_t i = c + 1; i<2*n; ++i) if (std::abs(panel(i,c)) > std::abs(panel(p,c))) p = i;
+				if (p != c) for (std::size_t j = 0; j<panel.cols(); ++j) std::swap(panel(c,j),panel(p,j));
+				if (panel(c,c) == T(0)) continue;
+				for (std::size_t i = c + 1; i<2*n; ++i)
+				{
+					T l = panel(i,c)/panel(c,c);
+					if (l != T(0)) for (std::size_t j = c; j<panel.cols(); ++j) panel(i,j) -= l*panel(c,j);
+				}
+			}
+			for (std::size_t i = 0; i<n; ++i)
+			{
+				for (std::size_t j = 0; j<n; ++j) { rest(i,j) = panel(n + i,n + j); rest(i,n + j) = panel(n + i,2*n + j); }
+				rest(i,2*n) = panel(n + i,3*n);
+			}
+			pivots.push_back(std::move(panel)); //Its first n rows: U*x_k + V*x_(k+1) + W*x_(m-1) = r, U upper triangular
+		}
+
+		//Last node: (C + E)*x_(m-1) = r
+		DenseMatrix<T> last(n,n);
+		std::vector<std::vector<T>> x(m,std::vector<T>(n));
+		for (std::size_t i = 0; i<n; ++i)
+		{
+			for (std::size_t j = 0; j<n; ++j) last(i,j) = rest(i,j) + rest(i,n + j);
+			x[m - 1][i] = rest(i,2*n);
+		}
+		DenseLU<T>(last).solve(x[m - 1]);
+
+		for (std::size_t k = m - 1; k-->0; )
+		{
+			const DenseMatrix<T>& panel = pivots[k];
+			for (std::size_t i = n; i-->0; )
+			{
+				T s = panel(i,3*n);
+				for (std::size_t j = 0; j<n; ++j) s -= panel(i,n + j)*x[k + 1][j] + panel(i,2*n + j)*x[m - 1][j];
+				for (std::size_t j = i + 1; j<n; ++j) s -= panel(i,j)*x[k][j];
+				x[k][i] = (panel(i,i) != T(0))?(s/panel(i,i)):T(0);
+			}
+		}
+		return x;
+	}
+
+public:
+	MultipleShooting(const M& m, unsigned int segments = 16, double tol = 1.e-10, unsigned int _max_iterations = 50,
+		const std::shared_ptr<ThreadPool>& _pool = nullptr, const Jacobian& _jacobian = Jacobian()) :
+		method(m), _segments(std::max(segments,1u)), _tolerance(tol), max_iterations(_max_iterations), pool(_pool), jacobian(_jacobian) { }
+
+	unsigned int segments() const { return _segments; }
+	double tolerance() const { return _tolerance; }
+	const std::shared_ptr<ThreadPool>& thread_pool() const { return pool; }
+
+	/* guess(t) gives the starting state at each node */
+	template<typename Function, typename BC, typename Guess, typename real>
+	auto solve(const Function& f, const BC& bc, const real& a, const real& b, const Guess& guess) const
+		-> BVPSolution<std::decay_t<decltype(guess(a))>,real>
+	{
+		using YType = std::decay_t<decltype(guess(a))>;
+		using T = typename state_traits<YType>::value_type;
+		using traits = state_traits<YType>;
+		const std::size_t m = _segments;
+
+		BVPSolution<YType,real> sol;
+		sol.iterations = 0; sol.converged = false; sol.residual = 0.0;
+		for (std::size_t k = 0; k<=m; ++k) sol.t.push_back((k == m)?b:(a + (b - a)*real(k)/real(m)));
+		for (std::size_t k = 0; k<m; ++k) sol.y.push_back(guess(sol.t[k]));
+		const std::size_t n = traits::size(sol.y[0]);
+
+		const VariationalProblem<Function,Jacobian> variational(f,jacobian);
+		std::vector<SensitivityState<YType>> ends(m);
+		auto segment = [&] (std::size_t k)
+		{
+			SensitivityState<YType> x(sol.y[k],n);
+			for (std::size_t j = 0; j<n; ++j) traits::at(x.s[j],j) = T(1);
+			ends[k] = method.solve(variational,sol.t[k],std::move(x),sol.t[k + 1]);
+		};
+
+		//Damped Newton: a step that does not reduce the residual is halved (down to 1/1024 of it)
+		std::vector<YType> previous;
+		std::vector<std::vector<T>> dx;
+		double previous_residual = 0.0, damping = 1.0;
+		for (;; ++sol.iterations)
+		{
+			if (pool) pool->parallel_for(m,segment);
+			else for (std::size_t k = 0; k<m; ++k) segment(k);
+
+			std::vector<std::vector<T>> residual(m,std::vector<T>(n));
+			double largest = 0.0;
+			for (std::size_t k = 0; k<m; ++k)
+			{
+				YType r = (k + 1<m)?YType(ends[k].y - sol.y[k + 1]):YType(bc(sol.y[0],ends[m - 1].y));
+				for (std::size_t i = 0; i<n; ++i)
+				{
+					residual[k][i] = traits::at(r,i);
+					double e = double(std::abs(residual[k][i]));
+					if (!(e <= largest)) largest = std::isnan(e)?HUGE_VAL:e;
+				}
+			}
+			sol.residual = largest;
+			if (!previous.empty() && !(sol.residual < previous_residual) && (damping > 1.0/1024.0) && (sol.iterations < max_iterations))
+			{
+				damping *= 0.5;
+				for (std::size_t k = 0; k<m; ++k)
+				{
+					sol.y[k] = previous[k];
+					for (std::size_t i = 0; i<n; ++i) traits::at(sol.y[k],i) += T(damping)*dx[k][i];
+				}
+				continue;
+			}
+			if (!std::isfinite(sol.residual) || (sol.residual <= _tolerance) || (sol.iterations >= max_iterations))
+			{
+				sol.converged = (sol.residual <= _tolerance);
+				break;
+			}
+
+			std::vector<DenseMatrix<T>> g(m,DenseMatrix<T>(n,n));
+			for (std::size_t k = 0; k<m; ++k)
+				for (std::size_t i = 0; i<n; ++i) for (std::size_t j = 0; j<n; ++j) g[k](i,j) = traits::at(ends[k].s[j],i);
+			const YType& y_b = ends[m - 1].y;
+			DenseMatrix<T> ba = FiniteDifferenceJacobian()([&] (const real&, const YType& y_a) { return YType(bc(y_a,y_b)); },a,sol.y[0]);
+			DenseMatrix<T> bb = FiniteDifferenceJacobian()([&] (const real&, const YType& y) { return YType(bc(sol.y[0],y)); },b,y_b);
+			DenseMatrix<T> bbg(n,n);
+			for (std::size_t i = 0; i<n; ++i) for (std::size_t l = 0; l<n; ++l) for (std::size_t j = 0; j<n; ++j)
+				bbg(i,j) += bb(i,l)*g[m - 1](l,j);
+
+			dx = solve_newton(g,ba,bbg,residual,n);
+			previous = sol.y; previous_residual = sol.residual; damping = 1.0;
+			for (std::size_t k = 0; k<m; ++k) for (std::size_t i = 0; i<n; ++i) traits::at(sol.y[k],i) += dx[k][i];
+		}
+		sol.y.push_back(ends[m - 1].y);
+		return sol;
+	}
+};
+
+template<typename M>
+MultipleShooting<M> multiple_shooting(const M& m, unsigned int segments = 16, double tol = 1.e-10, unsigned int max_iterations = 50,
+	const std::shared_ptr<ThreadPool>& pool = nullptr)
+{	return MultipleShooting<M>(m,segments,tol,max_iterations,pool); }
+
+}; //namespace IVP
+
+#endif
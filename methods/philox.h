@@ -0,0 +1,113 @@
+#ifndef _IVP_PHILOX_H_
+#define _IVP_PHILOX_H_
+
+#include <array>
+#include <cstdint>
+#include <cmath>
+
+namespace IVP {
+
+/* \brief Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3"), a counter based generator:
+ * the random numbers are a bijection of a 128 bit counter under a 64 bit key, with no state in between.
+ *
+ * block(c) gives the four 32 bit numbers of counter c. Blocks are independent of each other, so blocks(first,n)
+ * computes n consecutive ones lane by lane, in loops with no dependencies between lanes that the compiler turns
+ * into vector code.
+ */
+class Philox
+{
+	std::uint32_t k0, k1;
+
+	static constexpr std::uint32_t M0 = 0xD2511F53, M1 = 0xCD9E8D57;
+	static constexpr std::uint32_t W0 = 0x9E3779B9, W1 = 0xBB67AE85;
+public:
+	using Block = std::array<std::uint32_t,4>;
+
+	explicit Philox(std::uint64_t key = 0) : k0(std::uint32_t(key)), k1(std::uint32_t(key >> 32)) { }
+
+	Block block(const Block& counter) const
+	{
+		Block out;
+		blocks<1>(counter,1,&out);
+		return out;
+	}
+
+	/* n blocks, of counters (counter[0] + i, counter[1], counter[2], counter[3]) with the carry into counter[1] */
+	template<std::size_t Lanes = 16>
+	void blocks(const Block& counter, std::size_t n, Block* out) const
+	{
+		for (std::size_t first = 0; first<n; first+=Lanes)
+		{
+			std::uint32_t c0[Lanes], c1[Lanes], c2[Lanes], c3[Lanes];
+			for (std::size_t l = 0; l<Lanes; ++l)
+			{
+				std::uint64_t low = std::uint64_t(counter[0]) + first + l;
+				c0[l] = std::uint32_t(low); c1[l] = counter[1] + std::uint32_t(low >> 32);
+				c2[l] = counter[2]; c3[l] = counter[3];
+			}
+			std::uint32_t key0 = k0, key1 = k1;
+			for (int round = 0; round<10; ++round)
+			{
+				for (std::size_t l = 0; l<Lanes; ++l)
+				{
+					std::uint64_t p0 = std::uint64_t(M0)*c0[l], p1 = std::uint64_t(M1)*c2[l];
+					std::uint32_t n0 = std::uint32_t(p1 >> 32) ^ c1[l] ^ key0, n2 = std::uint32_t(p0 >> 32) ^ c3[l] ^ key1;
+					c1[l] = std::uint32_t(p1); c3[l] = std::uint32_t(p0);
+					c0[l] = n0; c2[l] = n2;
+				}
+				key0 += W0; key1 += W1;
+			}
+			for (std::size_t l = 0; (l<Lanes) && (first + l<n); ++l) out[first + l] = Block{{ c0[l], c1[l], c2[l], c3[l] }};
+		}
+	}
+};
+
+/* \brief Stream of standard normal numbers from Philox: the stream of a given (seed, id) is always the same,
+ * and streams of different ids never overlap (the id is the high half of the counter), whichever thread draws
+ * them and in whatever order. Use one id per Monte Carlo path.
+ *
+ * Numbers are made in batches of Batch blocks (4*Batch normals, Box-Muller on 32 bit uniforms), so the cost of
+ * one is a load from the buffer most of the time.
+ */
+class NormalStream
+{
+	static constexpr std::size_t Batch = 16;
+
+	Philox philox;
+	std::uint64_t id, next_block;
+	std::array<double,4*Batch> buffer;
+	std::size_t position;
+
+	void refill()
+	{
+		Philox::Block raw[Batch];
+		philox.blocks<Batch>(Philox::Block{{ std::uint32_t(next_block), std::uint32_t(next_block >> 32),
+			std::uint32_t(id), std::uint32_t(id >> 32) }},Batch,raw);
+		next_block += Batch;
+		const double two_pi = 6.283185307179586476925286766559, scale = 1.0/4294967296.0;
+		for (std::size_t b = 0; b<Batch; ++b)
+			for (std::size_t j = 0; j<4; j+=2)
+			{
+				double u1 = (double(raw[b][j]) + 1.0)*scale, u2 = double(raw[b][j + 1])*scale; //u1 in (0,1]
+				double r = std::sqrt(-2.0*std::log(u1));
+				buffer[4*b + j] = r*std::cos(two_pi*u2); buffer[4*b + j + 1] = r*std::sin(two_pi*u2);
+			}
+		position = 0;
+	}
+
+public:
+	NormalStream(std::uint64_t seed = 0, std::uint64_t _id = 0) :
+		philox(seed), id(_id), next_block(0), position(4*Batch) { }
+
+	std::uint64_t stream_id() const { return id; }
+
+	double operator()()
+	{
+		if (position == buffer.size()) refill();
+		return buffer[position++];
+	}
+};
+
+}; //namespace IVP
+
+#endif
@@ -1,6 +1,10 @@
 #ifndef _IVP_PROBLEM_H_
 #define _IVP_PROBLEM_H_
 
+#include <array>
+#include <utility>
+#include <type_traits>
+
 namespace IVP {
 
 	template<typename Function1, typename Function0>
@@ -18,6 +22,96 @@ namespace IVP {
 	LinearProblem<Function1,Function0> linear_problem(const Function1& c1, const Function0& c0)
 	{	return LinearProblem<Function1,Function0>(c1,c0); }
 
+	/* \brief Split problem y' = c1(t)*y + c0(t) + n(t,y): a (typically stiff) linear part plus a non stiff nonlinear one.
+	 *
+	 * IMEX methods (additive-runge-kutta.h) treat the linear part implicitly and n explicitly. Any other method
+	 * sees it as a whole, through operator().
+	 */
+	template<typename Function1, typename Function0, typename Nonlinear>
+	class AdditiveProblem : public LinearProblem<Function1,Function0>
+	{
+	public:
+		Nonlinear n;
+		AdditiveProblem(const Function1& _c1, const Function0& _c0, const Nonlinear& _n) :
+			LinearProblem<Function1,Function0>(_c1,_c0), n(_n) { }
+
+		template<typename real, typename YType>
+		YType operator()(const real& t, const YType& y) const { return this->c1(t)*y + this->c0(t) + n(t,y); }
+	};
+
+	template<typename Function1, typename Function0, typename Nonlinear>
+	AdditiveProblem<Function1,Function0,Nonlinear> additive_problem(const Function1& c1, const Function0& c0, const Nonlinear& n)
+	{	return AdditiveProblem<Function1,Function0,Nonlinear>(c1,c0,n); }
+
+	/* \brief Linear problem y' = c1*y + c0 whose coefficients do not depend on time. 
+	 *
+	 * c1 can be a scalar or anything that multiplies YType (a matrix). Methods that know about it precompute
+	 * their stability polynomial as a single propagator instead of running every stage. For an n x n matrix that
+	 * takes O(n^3) operations each time the step size changes, so it pays off with fixed steps, but not under
+	 * Adaptive, whose step changes at almost every step (see main/linear.cc).
+	 */
+	template<typename Coefficient1, typename Coefficient0>
+	class ConstantLinearProblem
+	{
+	public:
+		Coefficient1 c1; Coefficient0 c0;
+		ConstantLinearProblem(const Coefficient1& _c1, const Coefficient0& _c0) : c1(_c1), c0(_c0) { }
+
+		template<typename real, typename YType>
+		YType operator()(const real& t, const YType& y) const { return c1*y + c0; }
+	};
+
+	template<typename Coefficient1, typename Coefficient0>
+	ConstantLinearProblem<Coefficient1,Coefficient0> constant_linear_problem(const Coefficient1& c1, const Coefficient0& c0)
+	{	return ConstantLinearProblem<Coefficient1,Coefficient0>(c1,c0); }
+
+	/* \brief Precalculated step of a Runge-Kutta method over a ConstantLinearProblem. 
+	 *
+	 * If R(z) = 1 + r[0]*z + r[1]*z^2 + ... is the stability polynomial of the method, then a step of size h is
+	 *     y + (R(h*c1) - 1)*y + h*((R(z) - 1)/z)(h*c1)*c0
+	 * so we keep m = R(h*c1) - 1 and d = h*((R(z) - 1)/z)(h*c1)*c0, and only recalculate them when h changes. 
+	 * This way no identity matrix is needed. 
+	 */
+	template<typename Matrix, typename YType, typename real>
+	class LinearPropagator
+	{
+		real h; Matrix m; YType d;
+		bool valid;
+	public:
+		LinearPropagator() : h(0), m(), d(), valid(false) { }
+
+		template<typename C1, typename C0, std::size_t N>
+		void update(const ConstantLinearProblem<C1,C0>& f, const real& ht, const std::array<double,N>& r)
+		{
+			if (valid && (ht == h)) return;
+			Matrix z = ht*f.c1; Matrix zk = z;
+			YType v = f.c0;
+			m = real(r[0])*zk; d = (real(r[0])*ht)*v;
+			for (std::size_t k = 1; k<N; ++k)
+			{
+				zk = zk*z; v = z*v;
+				m = m + real(r[k])*zk; d = d + (real(r[k])*ht)*v;
+			}
+			h = ht; valid = true;
+		}
+
+		YType increment(const YType& y)  const { return m*y + d; }
+		YType operator()(const YType& y) const { return y + increment(y); }
+	};
+
+	/* \brief Type of the powers of h*c1 that a LinearPropagator keeps: c1 itself, evaluated if it is an expression
+	 * (Eigen's PlainObject). It needs scalar*matrix, matrix + matrix and matrix*matrix, as scalars, Eigen matrices
+	 * and DenseMatrix have.
+	 */
+	template<typename C1, typename Enable = void>
+	struct propagator_matrix { using type = std::decay_t<C1>; };
+
+	template<typename C1>
+	struct propagator_matrix<C1, std::void_t<typename C1::PlainObject>> { using type = typename C1::PlainObject; };
+
+	template<typename C1, typename YType, typename real>
+	using LinearPropagatorFor = LinearPropagator<typename propagator_matrix<C1>::type,YType,real>;
+
 };
 
 #endif
@@ -0,0 +1,119 @@
+#ifndef _IVP_REAL_TIME_H_
+#define _IVP_REAL_TIME_H_
+
+#include "integrator.h"
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+namespace IVP {
+
+/* \brief Work allowed to one call: evaluations of f and/or a deadline (whichever runs out first). */
+struct Budget
+{
+	std::size_t evaluations = std::numeric_limits<std::size_t>::max();
+	std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+};
+
+inline Budget evaluation_budget(std::size_t evaluations)
+{	Budget b; b.evaluations = evaluations; return b; }
+
+inline Budget time_budget(std::chrono::steady_clock::duration time)
+{	Budget b; b.deadline = std::chrono::steady_clock::now() + time; return b; }
+
+class BudgetExhausted : public std::runtime_error
+{
+public:
+	BudgetExhausted() : std::runtime_error("Budget exhausted") { }
+};
+
+/* Charges every evaluation of f to the current budget, and throws BudgetExhausted when it runs out. Evaluations
+ * can be charged from several threads at once (BulirschStoer with a pool, Adaptive::set_parallel).
+ */
+class BudgetMeter
+{
+	Budget budget;
+	std::atomic<std::size_t> used{0};
+public:
+	void start(const Budget& b) { budget = b; used = 0; }
+	std::size_t evaluations() const { return used.load(); }
+
+	void charge()
+	{
+		if ((budget.deadline != std::chrono::steady_clock::time_point::max()) && (std::chrono::steady_clock::now() >= budget.deadline))
+			throw BudgetExhausted();
+		std::size_t n = used.load(std::memory_order_relaxed);
+		do { if (n >= budget.evaluations) throw BudgetExhausted(); }
+		while (!used.compare_exchange_weak(n,n + 1,std::memory_order_relaxed));
+	}
+};
+
+template<typename Function>
+class Budgeted
+{
+	Function f; BudgetMeter* meter;
+public:
+	Budgeted(const Function& _f, BudgetMeter* _meter) : f(_f), meter(_meter) { }
+
+	template<typename real, typename YType>
+	auto operator()(const real& t, const YType& y) const -> decltype(f(t,y))
+	{
+		meter->charge();
+		return f(t,y);
+	}
+};
+
+/* \brief What a budgeted call got to: the state at t, which is the requested time if complete. */
+template<typename YType, typename real>
+struct Advance
+{
+	YType y; real t; bool complete;
+};
+
+/**
+ * Integrator (see integrator.h) for loops with hard deadlines: each advance_to gets a Budget, and when it runs
+ * out the call returns at once with the state of the last step it completed (complete = false), instead of
+ * going on through step rejections or implicit iterations. The next call goes on from there, so a slow stretch
+ * is caught up over the following calls.
+ *
+ * The work is counted at each evaluation of f, so a call overshoots its deadline by at most one evaluation and
+ * the bookkeeping of a step. Each step is taken on a copy of the state and of the data between steps, so an
+ * abandoned step (or substeps of it) leaves the last complete one intact. If the budget runs out while
+ * interpolating at the end (up to two evaluations), the state is that of the end of the step, just after the
+ * requested time.
+ */
+template<typename M, typename YType, typename Function, typename real = double>
+class RealTimeIntegrator
+{
+	std::unique_ptr<BudgetMeter> meter;
+	Integrator<M,YType,Budgeted<Function>,real> integrator;
+public:
+	RealTimeIntegrator(const M& m, const Function& f, const real& t_ini, const YType& y_ini, const real& t_end) :
+		meter(new BudgetMeter()), integrator(m,Budgeted<Function>(f,meter.get()),t_ini,y_ini,t_end) { }
+
+	const real& t()                 const { return integrator.t(); }
+	const YType& y()                const { return integrator.y(); }
+	const real& t_end()             const { return integrator.t_end(); }
+	std::size_t steps_taken()       const { return integrator.steps_taken(); }
+	/* Used by the last call */
+	std::size_t evaluations()       const { return meter->evaluations(); }
+
+	Advance<YType,real> advance_to(const real& t, const Budget& budget)
+	{
+		meter->start(budget);
+		try { return Advance<YType,real>{ integrator.advance_to(t), t, true }; }
+		catch (const BudgetExhausted&) { return Advance<YType,real>{ integrator.y(), integrator.t(), false }; }
+	}
+};
+
+template<typename M, typename YType, typename Function, typename real>
+RealTimeIntegrator<M,YType,std::decay_t<Function>,real> real_time_integrator(const M& m, const Function& f, const real& t_ini,
+	const YType& y_ini, const real& t_end)
+{	return RealTimeIntegrator<M,YType,std::decay_t<Function>,real>(m,f,t_ini,y_ini,t_end); }
+
+}; //namespace IVP
+
+#endif
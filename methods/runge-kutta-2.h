@@ -13,7 +13,7 @@ class RungeKutta2 : public Method<RungeKutta2>
 public:
 //	This works only on gcc >= 2.7
 //		using Method<RungeKutta2<real>,real>::Method;
-	RungeKutta2(float s) :   Method<RungeKutta2>(s)  { }
+	RungeKutta2(double s) :   Method<RungeKutta2>(s)  { }
 	RungeKutta2(unsigned int ns = 1) : Method<RungeKutta2>(ns) { }
 	RungeKutta2(int ns) : Method<RungeKutta2>((unsigned int)ns) { }
 
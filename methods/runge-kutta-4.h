@@ -18,7 +18,7 @@ class RungeKutta4 : public Method<RungeKutta4>
 public:
 //	This works only on gcc >= 2.7
 //		using Method<RungeKutta4<real>,real>::Method;
-	RungeKutta4(float s) :   Method<RungeKutta4>(s)  { }
+	RungeKutta4(double s) :   Method<RungeKutta4>(s)  { }
 	RungeKutta4(unsigned int ns) : Method<RungeKutta4>(ns) { }
 	RungeKutta4(int ns = 1) : Method<RungeKutta4>((unsigned int)ns) { }
 
@@ -38,6 +38,19 @@ public:
 		return std::make_tuple(f.c0(t_ini),f.c1(t_ini));
 	}
 
+	/* If the coefficients are constant, the whole step is a single propagator that we keep between steps
+	 * (and only recalculate when the step size changes).
+	 */
+	template<typename YType, typename C1, typename C0, typename real>  
+	LinearPropagatorFor<C1,YType,real> 
+		between_steps_first(const ConstantLinearProblem<C1, C0>& f, const real& t_ini, const YType& y_ini, const real& t_end) const
+	{
+		return LinearPropagatorFor<C1,YType,real>();
+	}
+
+	/* R(z) = 1 + z + z^2/2 + z^3/6 + z^4/24 */
+	static std::array<double,4> stability_polynomial() { return {{ 1.0, 1.0/2.0, 1.0/6.0, 1.0/24.0 }}; }
+
 	template<typename YType, typename Function, typename real>  
 	real next(const Function& f, const real& t, YType& y_t, const real& ht) const
 	{
@@ -62,6 +75,15 @@ public:
 		y_t = y_t + real(1.0/6.0)*k1 + real(1.0/3.0)*k2 + real(1.0/3.0)*k3+ real(1.0/6.0)*k4;
 		return t+ht;
 	}
+
+	template<typename YType, typename C1, typename C0, typename real, typename Matrix>  
+	real next(const ConstantLinearProblem<C1, C0>& f, const real& t, YType& y_t, const real& ht, 
+		LinearPropagator<Matrix,YType,real>& propagator) const
+	{
+		propagator.update(f,ht,stability_polynomial());
+		y_t = propagator(y_t);
+		return t+ht;
+	}
 };
 
 };
@@ -0,0 +1,72 @@
+#ifndef _IVP_RUNGEKUTTANYSTROM_H_
+#define _IVP_RUNGEKUTTANYSTROM_H_
+
+#include "method.h"
+#include "second-order.h"
+
+namespace IVP
+{
+
+/**
+ * Nystrom's fourth order method for y'' = f(t,y) over SecondOrderState: three evaluations of f per step,
+ * where RungeKutta4 over first_order(f) needs four (and twice the vector operations).
+ *     c = (0, 1/2, 1), a21 = 1/8, a32 = 1/2, b(y) = (1/6, 1/3, 0), b(y') = (1/6, 4/6, 1/6)
+ * where stage i evaluates f at y + c_i*h*y' + h^2*sum_j a_ij*k_j.
+ */
+class RungeKuttaNystrom4 : public Method<RungeKuttaNystrom4>
+{
+public:
+	RungeKuttaNystrom4(double s) :   Method<RungeKuttaNystrom4>(s)  { }
+	RungeKuttaNystrom4(unsigned int ns) : Method<RungeKuttaNystrom4>(ns) { }
+	RungeKuttaNystrom4(int ns = 1) : Method<RungeKuttaNystrom4>((unsigned int)ns) { }
+
+	template<typename YType, typename Function, typename real>
+	real next(const Function& f, const real& t, SecondOrderState<YType>& x, const real& h) const
+	{
+		real h2 = h*h;
+		YType k1 = f(t, x.y);
+		YType k2 = f(t+real(0.5)*h, linear_combination(x.y, {double(h)/2.0, double(h2)/8.0}, x.v, k1));
+		YType k3 = f(t+h, linear_combination(x.y, {double(h), double(h2)/2.0}, x.v, k2));
+		linear_combination_inplace(x.y, {double(h), double(h2)/6.0, double(h2)/3.0}, x.v, k1, k2);
+		linear_combination_inplace(x.v, {double(h)/6.0, double(h)*4.0/6.0, double(h)/6.0}, k1, k2, k3);
+		return t+h;
+	}
+};
+
+/**
+ * RungeKuttaNystrom4 with an embedded third order velocity for Adaptive. The last stage is replaced by the
+ * evaluation at the new position, which is needed anyway by the next step (FSAL), so it still takes three
+ * evaluations of f per step:
+ *     y'(other) = y' + h/6*(k1 + 4*k2 + f(t+h,y_new))
+ * which differs from the fourth order one by h/6*(k3 - f(t+h,y_new)) = O(h^4).
+ */
+class RungeKuttaNystrom43 : public MethodEmbedded<RungeKuttaNystrom43>
+{
+public:
+	RungeKuttaNystrom43(double initial_step) : MethodEmbedded<RungeKuttaNystrom43>(initial_step) { }
+	RungeKuttaNystrom43(unsigned int ns = 1) : MethodEmbedded<RungeKuttaNystrom43>(ns) { }
+	RungeKuttaNystrom43(int ns) : MethodEmbedded<RungeKuttaNystrom43>((unsigned int)ns) { }
+
+	template<typename YType, typename Function, typename real>
+	YType between_steps_first(const Function& f, const real& t_ini, const SecondOrderState<YType>& x_ini, const real& t_end) const
+	{	return f(t_ini, x_ini.y); }
+
+	template<typename YType, typename Function, typename real>
+	real next_embedded(const Function& f, real t, SecondOrderState<YType>& x, real& h, YType& k1, SecondOrderState<YType>& other) const
+	{
+		real h2 = h*h;
+		YType k2 = f(t+real(0.5)*h, linear_combination(x.y, {double(h)/2.0, double(h2)/8.0}, x.v, k1));
+		YType k3 = f(t+h, linear_combination(x.y, {double(h), double(h2)/2.0}, x.v, k2));
+		linear_combination_inplace(x.y, {double(h), double(h2)/6.0, double(h2)/3.0}, x.v, k1, k2);
+		YType k4 = f(t+h, x.y);
+		other.y = x.y;
+		other.v = linear_combination(x.v, {double(h)/6.0, double(h)*4.0/6.0, double(h)/6.0}, k1, k2, k4);
+		linear_combination_inplace(x.v, {double(h)/6.0, double(h)*4.0/6.0, double(h)/6.0}, k1, k2, k3);
+		k1 = k4;
+		return t+h;
+	}
+};
+
+};
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef _IVP_SECOND_ORDER_H_
+#define _IVP_SECOND_ORDER_H_
+
+#include "state.h"
+#include <type_traits>
+
+namespace IVP {
+
+/* \brief State (y, y') of a second order problem y'' = f(t,y).
+ *
+ * Runge-Kutta-Nystrom methods (stormer-verlet.h, runge-kutta-nystrom.h) integrate it with f returning only
+ * the acceleration. Any other method can integrate it through first_order(f).
+ */
+template<typename YType>
+class SecondOrderState
+{
+public:
+	YType y, v;
+
+	SecondOrderState() { }
+	SecondOrderState(const YType& _y, const YType& _v) : y(_y), v(_v) { }
+
+	friend SecondOrderState operator+(const SecondOrderState& a, const SecondOrderState& b)
+	{	return SecondOrderState(a.y + b.y, a.v + b.v); }
+	friend SecondOrderState operator-(const SecondOrderState& a, const SecondOrderState& b)
+	{	return SecondOrderState(a.y - b.y, a.v - b.v); }
+	friend SecondOrderState operator-(const SecondOrderState& a)
+	{	return SecondOrderState(-a.y, -a.v); }
+
+	template<typename S, typename = typename std::enable_if<std::is_arithmetic<S>::value>::type>
+	friend SecondOrderState operator*(const S& k, const SecondOrderState& a)
+	{	return SecondOrderState(k*a.y, k*a.v); }
+	template<typename S, typename = typename std::enable_if<std::is_arithmetic<S>::value>::type>
+	friend SecondOrderState operator*(const SecondOrderState& a, const S& k)
+	{	return k*a; }
+	template<typename S, typename = typename std::enable_if<std::is_arithmetic<S>::value>::type>
+	friend SecondOrderState operator/(const SecondOrderState& a, const S& k)
+	{	return SecondOrderState(a.y/k, a.v/k); }
+};
+
+template<typename YType>
+SecondOrderState<YType> second_order_state(const YType& y, const YType& v) { return SecondOrderState<YType>(y,v); }
+
+/* Elements are y first and then y'. Combinations are done blockwise. */
+template<typename YType>
+struct state_traits<SecondOrderState<YType>>
+{
+	using value_type = typename state_traits<YType>::value_type;
+
+	static std::size_t size(const SecondOrderState<YType>& x) { return 2*state_traits<YType>::size(x.y); }
+	static decltype(auto) at(const SecondOrderState<YType>& x, std::size_t i)
+	{
+		std::size_t n = state_traits<YType>::size(x.y);
+		return (i<n)?state_traits<YType>::at(x.y,i):state_traits<YType>::at(x.v,i-n);
+	}
+	static decltype(auto) at(SecondOrderState<YType>& x, std::size_t i)
+	{
+		std::size_t n = state_traits<YType>::size(x.y);
+		return (i<n)?state_traits<YType>::at(x.y,i):state_traits<YType>::at(x.v,i-n);
+	}
+
+	static value_type norm(const SecondOrderState<YType>& x)
+	{	return std::max(state_traits<YType>::norm(x.y),state_traits<YType>::norm(x.v)); }
+
+	template<std::size_t N, typename... K>
+	static SecondOrderState<YType> linear_combination(const SecondOrderState<YType>& x, const double (&c)[N], const K&... k)
+	{
+		return SecondOrderState<YType>(state_traits<YType>::linear_combination(x.y,c,k.y...),
+		                               state_traits<YType>::linear_combination(x.v,c,k.v...));
+	}
+
+	template<std::size_t N, typename... K>
+	static void linear_combination_inplace(SecondOrderState<YType>& x, const double (&c)[N], const K&... k)
+	{
+		state_traits<YType>::linear_combination_inplace(x.y,c,k.y...);
+		state_traits<YType>::linear_combination_inplace(x.v,c,k.v...);
+	}
+};
+
+/* \brief y'' = f(t,y) as the first order system (y, v)' = (v, f(t,y)). */
+template<typename Function>
+class FirstOrder
+{
+public:
+	Function f;
+	FirstOrder(const Function& _f) : f(_f) { }
+
+	template<typename real, typename YType>
+	SecondOrderState<YType> operator()(const real& t, const SecondOrderState<YType>& x) const
+	{	return SecondOrderState<YType>(x.v,f(t,x.y)); }
+};
+
+template<typename Function>
+FirstOrder<Function> first_order(const Function& f) { return FirstOrder<Function>(f); }
+
+}; //namespace IVP
+
+#endif
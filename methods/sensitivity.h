@@ -0,0 +1,182 @@
+#ifndef _IVP_SENSITIVITY_H_
+#define _IVP_SENSITIVITY_H_
+
+#include "state.h"
+#include "adaptive.h"
+#include <vector>
+#include <type_traits>
+
+namespace IVP {
+
+/* \brief State augmented with its sensitivity matrix S = dy/dp, stored as one column (a YType) per parameter.
+ *
+ * Integrating it with any method advances y and S on the same steps, and error control (Adaptive) sees the
+ * sensitivities too.
+ */
+template<typename YType>
+class SensitivityState
+{
+	//v = k*v, element by element where state_traits gives write access to them, and with operator* otherwise
+	template<typename S, typename Y = YType>
+	static auto scale(Y& v, const S& k, int) -> decltype(void(state_traits<Y>::at(v,0) *= k))
+	{	for (std::size_t i = 0; i<state_traits<Y>::size(v); ++i) state_traits<Y>::at(v,i) *= k; }
+	template<typename S, typename Y = YType>
+	static void scale(Y& v, const S& k, long) { v = k*v; }
+
+public:
+	YType y; std::vector<YType> s;
+
+	SensitivityState() { }
+	explicit SensitivityState(const YType& _y) : y(_y) { }
+	SensitivityState(const YType& _y, const std::vector<YType>& _s) : y(_y), s(_s) { }
+	SensitivityState(const YType& _y, std::size_t parameters) : y(_y), s(parameters,_y - _y) { }
+
+	std::size_t parameters() const { return s.size(); }
+	const YType& sensitivity(std::size_t p) const { return s[p]; }
+
+	friend SensitivityState operator+(const SensitivityState& a, const SensitivityState& b)
+	{	SensitivityState sol(a.y + b.y); sol.s.reserve(a.s.size()); for (std::size_t j = 0; j<a.s.size(); ++j) sol.s.push_back(a.s[j] + b.s[j]); return sol; }
+	friend SensitivityState operator-(const SensitivityState& a, const SensitivityState& b)
+	{	SensitivityState sol(a.y - b.y); sol.s.reserve(a.s.size()); for (std::size_t j = 0; j<a.s.size(); ++j) sol.s.push_back(a.s[j] - b.s[j]); return sol; }
+	friend SensitivityState operator-(const SensitivityState& a)
+	{	SensitivityState sol(-a.y); sol.s.reserve(a.s.size()); for (std::size_t j = 0; j<a.s.size(); ++j) sol.s.push_back(-a.s[j]); return sol; }
+
+	template<typename S, typename = typename std::enable_if<std::is_arithmetic<S>::value>::type>
+	friend SensitivityState operator*(const S& k, const SensitivityState& a)
+	{	SensitivityState sol(k*a.y); sol.s.reserve(a.s.size()); for (std::size_t j = 0; j<a.s.size(); ++j) sol.s.push_back(k*a.s[j]); return sol; }
+	//h*f(t,y) in every stage: the evaluation is scaled in place instead of allocating y and all the columns again
+	template<typename S, typename = typename std::enable_if<std::is_arithmetic<S>::value>::type>
+	friend SensitivityState operator*(const S& k, SensitivityState&& a)
+	{
+		scale(a.y,k,0);
+		for (YType& c : a.s) scale(c,k,0);
+		return std::move(a);
+	}
+	template<typename S, typename = typename std::enable_if<std::is_arithmetic<S>::value>::type>
+	friend SensitivityState operator*(const SensitivityState& a, const S& k)
+	{	return k*a; }
+	template<typename S, typename = typename std::enable_if<std::is_arithmetic<S>::value>::type>
+	friend SensitivityState operator/(const SensitivityState& a, const S& k)
+	{	SensitivityState sol(a.y/k); sol.s.reserve(a.s.size()); for (std::size_t j = 0; j<a.s.size(); ++j) sol.s.push_back(a.s[j]/k); return sol; }
+};
+
+/* Initial state with no dependency of y_ini on the parameters (S = 0). */
+template<typename YType>
+SensitivityState<YType> sensitivity_state(const YType& y_ini, std::size_t parameters)
+{	return SensitivityState<YType>(y_ini,parameters); }
+
+/* Initial state with a given dy_ini/dp (for parameters that appear in the initial condition). */
+template<typename YType>
+SensitivityState<YType> sensitivity_state(const YType& y_ini, const std::vector<YType>& s_ini)
+{	return SensitivityState<YType>(y_ini,s_ini); }
+
+/* \brief Forward sensitivity equations of y' = f(t,y,p):
+ *     y'   = f(t,y)
+ *     S_j' = df/dy(t,y)*S_j + df/dp_j(t,y)
+ *
+ * dfdy(t,y) returns anything that multiplies YType (a scalar or a matrix), and dfdp(t,y) returns an indexable
+ * container with a YType per parameter. The Jacobians are evaluated once per stage and shared by all columns.
+ */
+template<typename Function, typename Dfdy, typename Dfdp>
+class ForwardSensitivityProblem
+{
+public:
+	Function f; Dfdy dfdy; Dfdp dfdp;
+	ForwardSensitivityProblem(const Function& _f, const Dfdy& _dfdy, const Dfdp& _dfdp) : f(_f), dfdy(_dfdy), dfdp(_dfdp) { }
+
+	template<typename real, typename YType>
+	SensitivityState<YType> operator()(const real& t, const SensitivityState<YType>& x) const
+	{
+		auto jy = dfdy(t,x.y);
+		auto jp = dfdp(t,x.y);
+		SensitivityState<YType> sol(f(t,x.y));
+		sol.s.reserve(x.s.size());
+		for (std::size_t j = 0; j<x.s.size(); ++j)
+		{
+			sol.s.push_back(jy*x.s[j]);
+			state_traits<YType>::linear_combination_inplace(sol.s.back(),{1.0},jp[j]);
+		}
+		return sol;
+	}
+};
+
+template<typename Function, typename Dfdy, typename Dfdp>
+ForwardSensitivityProblem<Function,Dfdy,Dfdp> forward_sensitivity(const Function& f, const Dfdy& dfdy, const Dfdp& dfdp)
+{	return ForwardSensitivityProblem<Function,Dfdy,Dfdp>(f,dfdy,dfdp); }
+
+/* \brief Error estimation on SensitivityState for Adaptive methods.
+ *
+ * By default only y drives the step size and the sensitivities follow the same steps. Relative error on
+ * sensitivities that start at zero (or cross it) is very pessimistic, so including them is optional.
+ */
+template<typename Estimator = ErrorEstimator>
+class SensitivityErrorEstimator : public Estimator
+{
+	bool include_sensitivities;
+public:
+	SensitivityErrorEstimator(bool _include_sensitivities = false, const Estimator& e = Estimator()) :
+		Estimator(e), include_sensitivities(_include_sensitivities) { }
+
+	using Estimator::estimate_error;
+
+	template<typename YType>
+	auto estimate_error(const SensitivityState<YType>& e1, const SensitivityState<YType>& e2) const
+		-> decltype(std::declval<const Estimator&>().estimate_error(e1.y,e2.y))
+	{
+		auto sol = Estimator::estimate_error(e1.y,e2.y);
+		if (include_sensitivities) for (std::size_t j = 0; j<e1.s.size(); ++j)
+		{
+			auto err = Estimator::estimate_error(e1.s[j],e2.s[j]);
+			if (err>sol) sol = err;
+		}
+		return sol;
+	}
+};
+
+/* Elements are y first and then each column. Combinations are done blockwise, so y and the columns use the
+ * fused kernels of YType.
+ */
+template<typename YType>
+struct state_traits<SensitivityState<YType>>
+{
+	using value_type = typename state_traits<YType>::value_type;
+
+	static std::size_t size(const SensitivityState<YType>& v) { return state_traits<YType>::size(v.y)*(1 + v.s.size()); }
+	static decltype(auto) at(const SensitivityState<YType>& v, std::size_t i)
+	{
+		std::size_t n = state_traits<YType>::size(v.y);
+		return (i<n)?state_traits<YType>::at(v.y,i):state_traits<YType>::at(v.s[i/n - 1],i%n);
+	}
+	static decltype(auto) at(SensitivityState<YType>& v, std::size_t i)
+	{
+		std::size_t n = state_traits<YType>::size(v.y);
+		return (i<n)?state_traits<YType>::at(v.y,i):state_traits<YType>::at(v.s[i/n - 1],i%n);
+	}
+
+	static value_type norm(const SensitivityState<YType>& v)
+	{
+		value_type sol = state_traits<YType>::norm(v.y);
+		for (const YType& c : v.s) { value_type n = state_traits<YType>::norm(c); if (sol < n) sol = n; }
+		return sol;
+	}
+
+	template<std::size_t N, typename... K>
+	static SensitivityState<YType> linear_combination(const SensitivityState<YType>& y, const double (&c)[N], const K&... k)
+	{
+		SensitivityState<YType> sol(state_traits<YType>::linear_combination(y.y,c,k.y...));
+		sol.s.reserve(y.s.size());
+		for (std::size_t j = 0; j<y.s.size(); ++j) sol.s.push_back(state_traits<YType>::linear_combination(y.s[j],c,k.s[j]...));
+		return sol;
+	}
+
+	template<std::size_t N, typename... K>
+	static void linear_combination_inplace(SensitivityState<YType>& y, const double (&c)[N], const K&... k)
+	{
+		state_traits<YType>::linear_combination_inplace(y.y,c,k.y...);
+		for (std::size_t j = 0; j<y.s.size(); ++j) state_traits<YType>::linear_combination_inplace(y.s[j],c,k.s[j]...);
+	}
+};
+
+}; //namespace IVP
+
+#endif
@@ -0,0 +1,241 @@
+#ifndef _IVP_SPLITTING_H_
+#define _IVP_SPLITTING_H_
+
+#include "method.h"
+#include "adaptive.h"
+#include <tuple>
+#include <array>
+#include <vector>
+#include <utility>
+#include <cmath>
+#include <limits>
+
+namespace IVP {
+
+/* \brief Problem y' = f_1(t,y) + f_2(t,y) + ... given as its parts, for Splitting.
+ *
+ * operator() adds them up, so any other method can integrate it as a whole (i.e. for a reference solution).
+ */
+template<typename... Functions>
+class SplitProblem
+{
+public:
+	std::tuple<Functions...> parts;
+	SplitProblem(const Functions&... f) : parts(f...) { }
+
+	template<typename real, typename YType>
+	YType operator()(const real& t, const YType& y) const { return sum(t,y,std::index_sequence_for<Functions...>()); }
+
+private:
+	template<typename real, typename YType, std::size_t... I>
+	YType sum(const real& t, const YType& y, std::index_sequence<I...>) const
+	{	return (... + std::get<I>(parts)(t,y)); }
+};
+
+template<typename... Functions>
+SplitProblem<Functions...> split_problem(const Functions&... f) { return SplitProblem<Functions...>(f...); }
+
+/* \brief Splitting schemes, as the sequence of (part, fraction of the step) flows that make a step.
+ *
+ * Consecutive flows of the same part are merged, so the sequences can be composed freely.
+ */
+using SplittingSequence = std::vector<std::pair<std::size_t,double>>;
+
+inline void append_flow(SplittingSequence& s, std::size_t part, double fraction)
+{
+	if ((!s.empty()) && (s.back().first == part)) s.back().second += fraction;
+	else s.emplace_back(part,fraction);
+}
+
+/* Lie-Trotter, first order: f_1 for the whole step, then f_2... */
+struct Lie
+{
+	static SplittingSequence sequence(std::size_t parts, double scale = 1.0)
+	{
+		SplittingSequence s;
+		for (std::size_t i = 0; i<parts; ++i) append_flow(s,i,scale);
+		return s;
+	}
+};
+
+/* Strang, second order: half steps of f_1..f_{n-1} around a full step of f_n */
+struct Strang
+{
+	static SplittingSequence sequence(std::size_t parts, double scale = 1.0)
+	{
+		SplittingSequence s;
+		for (std::size_t i = 0; i+1<parts; ++i) append_flow(s,i,0.5*scale);
+		append_flow(s,parts-1,scale);
+		for (std::size_t i = parts-1; i-->0; ) append_flow(s,i,0.5*scale);
+		return s;
+	}
+};
+
+/* Yoshida's triple jump over Strang, fourth order. The middle substep goes backwards in time, so every part must
+ * be integrable backwards (which rules out diffusion and other dissipative parts).
+ */
+struct Yoshida4
+{
+	static SplittingSequence sequence(std::size_t parts, double scale = 1.0)
+	{
+		const double c = std::cbrt(2.0), w1 = 1.0/(2.0 - c), w0 = -c/(2.0 - c);
+		SplittingSequence s;
+		for (double w : { w1, w0, w1 })
+			for (const auto& flow : Strang::sequence(parts,w*scale)) append_flow(s,flow.first,flow.second);
+		return s;
+	}
+};
+
+/* \brief Whether a method keeps its own step size from one call of next to the following (Adaptive does). The
+ * others take m.step(length) for each flow.
+ */
+template<typename M>
+struct keeps_step_size : std::false_type { };
+template<typename B, typename E, typename A, bool embedded>
+struct keeps_step_size<Adaptive<B,E,A,embedded>> : std::true_type { };
+
+/* \brief What each part keeps between flows: its own step size and the data of its method. */
+template<typename real, typename BetweenSteps>
+struct SplitFlow
+{
+	real h; BetweenSteps bs;
+};
+
+template<typename real>
+struct SplitFlow<real,void>
+{
+	real h;
+};
+
+template<typename Flows>
+struct SplitData
+{
+	Flows flows;
+	std::size_t last; //Last part that moved y (none yet if npos)
+};
+
+/**
+ * Operator splitting: each part of a SplitProblem is integrated with its own method (the i-th method takes the
+ * i-th part), in the order of the Scheme. Each flow is a full integration of a part over its fraction of the
+ * step, with as many substeps as its method takes.
+ *
+ * The data between steps of each method (caches, FSAL evaluations) and, for adaptive methods, their step size
+ * survive from one step to the next. FSAL evaluations (data between steps of the same type as y) are the only
+ * ones that depend on y, so they are evaluated again when another part has moved y since.
+ */
+template<typename Scheme, typename... Methods>
+class Splitting : public Method<Splitting<Scheme,Methods...>>
+{
+	std::tuple<Methods...> methods;
+	SplittingSequence sequence;
+
+	template<std::size_t I, typename YType, typename Function, typename real>
+	using FlowFor = SplitFlow<real,typename Type<typename std::tuple_element<I,std::tuple<Methods...>>::type,YType,Function,real>::BetweenSteps>;
+
+public:
+	Splitting(const Methods&... m) : Splitting(1u,m...) { }
+	Splitting(unsigned int ns, const Methods&... m) :
+		Method<Splitting<Scheme,Methods...>>(ns), methods(m...), sequence(Scheme::sequence(sizeof...(Methods))) { }
+	Splitting(double s, const Methods&... m) :
+		Method<Splitting<Scheme,Methods...>>(s), methods(m...), sequence(Scheme::sequence(sizeof...(Methods))) { }
+
+	const SplittingSequence& flows() const { return sequence; }
+
+	template<typename YType, typename... Functions, typename real>
+	auto between_steps_first(const SplitProblem<Functions...>& f, const real& t_ini, const YType& y_ini, const real& t_end) const
+	{
+		static_assert(sizeof...(Functions) == sizeof...(Methods), "There must be a method for each part of the problem");
+		return first(f,t_ini,y_ini,t_end,std::index_sequence_for<Methods...>());
+	}
+
+	template<typename YType, typename... Functions, typename real, typename Flows>
+	real next(const SplitProblem<Functions...>& f, const real& t, YType& y_t, const real& ht, SplitData<Flows>& data) const
+	{
+		std::array<real,sizeof...(Methods)> clocks; clocks.fill(t); //Each part has its own time
+		for (const auto& flow : sequence)
+			dispatch(f,flow.first,clocks,y_t,real(flow.second)*ht,data,std::index_sequence_for<Methods...>());
+		return t+ht;
+	}
+
+private:
+	template<typename YType, typename... Functions, typename real, std::size_t... I>
+	auto first(const SplitProblem<Functions...>& f, const real& t_ini, const YType& y_ini, const real& t_end, std::index_sequence<I...>) const
+	{
+		using Flows = std::tuple<FlowFor<I,YType,Functions,real>...>;
+		return SplitData<Flows>{ Flows(flow_first<I>(f,t_ini,y_ini,t_end)...), std::numeric_limits<std::size_t>::max() };
+	}
+
+	template<std::size_t I, typename YType, typename... Functions, typename real>
+	auto flow_first(const SplitProblem<Functions...>& f, const real& t_ini, const YType& y_ini, const real& t_end) const
+	{
+		using Flow = FlowFor<I,YType,typename std::tuple_element<I,std::tuple<Functions...>>::type,real>;
+		Flow flow; flow.h = std::get<I>(methods).step(t_end - t_ini);
+		init(flow,std::get<I>(methods),std::get<I>(f.parts),t_ini,y_ini,t_end);
+		return flow;
+	}
+
+	template<typename real, typename M, typename F, typename YType>
+	static void init(SplitFlow<real,void>& flow, const M& m, const F& f, const real& t_ini, const YType& y_ini, const real& t_end) { }
+	template<typename real, typename BS, typename M, typename F, typename YType>
+	static void init(SplitFlow<real,BS>& flow, const M& m, const F& f, const real& t_ini, const YType& y_ini, const real& t_end)
+	{	flow.bs = wrapped_between_steps_first(m,f,t_ini,y_ini,t_end); }
+
+	template<typename YType, typename... Functions, typename real, typename Flows, std::size_t... I>
+	void dispatch(const SplitProblem<Functions...>& f, std::size_t part, std::array<real,sizeof...(Methods)>& clocks, YType& y_t,
+		const real& length, SplitData<Flows>& data, std::index_sequence<I...>) const
+	{
+		((part == I ? run<I>(f,clocks[I],y_t,length,data) : void()), ...);
+	}
+
+	template<std::size_t I, typename YType, typename... Functions, typename real, typename Flows>
+	void run(const SplitProblem<Functions...>& f, real& t, YType& y_t, const real& length, SplitData<Flows>& data) const
+	{
+		const auto& m = std::get<I>(methods);
+		const auto& g = std::get<I>(f.parts);
+		auto& flow = std::get<I>(data.flows);
+		if ((data.last != std::numeric_limits<std::size_t>::max()) && (data.last != I)) reseed(flow,g,t,y_t);
+		data.last = I;
+
+		real t_end = t + length;
+		real h = std::copysign(std::abs(keeps_step_size<typename std::decay<decltype(m)>::type>::value? flow.h : m.step(length)),length);
+		const real ulps = real(4)*std::numeric_limits<real>::epsilon()*std::abs(t_end);
+		//Until the flow gets to t_end: an adaptive method may reject the clipped last step and take a shorter one
+		while ((length>0)?(t < t_end):(t > t_end))
+		{
+			bool last = (length>0)?(t + h >= t_end):(t + h <= t_end);
+			real step = last?(t_end - t):h;
+			real taken = step;
+			t = advance(m,g,t,y_t,step,flow);
+			//Adaptive methods propose their next step. A clipped last step only lowers it if it was rejected.
+			if ((!last) || (std::abs(step) < std::abs(taken))) h = step;
+			if (std::abs(t_end - t) <= ulps) t = t_end; //t + (t_end - t) may round to just before t_end
+		}
+		flow.h = h;
+	}
+
+	template<typename M, typename F, typename real, typename YType>
+	static real advance(const M& m, const F& f, const real& t, YType& y_t, real& h, SplitFlow<real,void>& flow)
+	{	return m.next(f,t,y_t,h); }
+	template<typename M, typename F, typename real, typename YType, typename BS>
+	static real advance(const M& m, const F& f, const real& t, YType& y_t, real& h, SplitFlow<real,BS>& flow)
+	{	return m.next(f,t,y_t,h,flow.bs); }
+
+	//Other data between steps (caches of coefficients, factorizations, step sizes) does not depend on y
+	template<typename real, typename BS, typename F, typename YType>
+	static void reseed(SplitFlow<real,BS>& flow, const F& f, const real& t, const YType& y_t) { }
+	template<typename real, typename F, typename YType>
+	static void reseed(SplitFlow<real,void>& flow, const F& f, const real& t, const YType& y_t) { }
+	template<typename real, typename F, typename YType>
+	static void reseed(SplitFlow<real,YType>& flow, const F& f, const real& t, const YType& y_t) { flow.bs = f(t,y_t); }
+};
+
+template<typename... Methods>
+Splitting<Lie,Methods...> lie_splitting(unsigned int ns, const Methods&... m) { return Splitting<Lie,Methods...>(ns,m...); }
+template<typename... Methods>
+Splitting<Strang,Methods...> strang_splitting(unsigned int ns, const Methods&... m) { return Splitting<Strang,Methods...>(ns,m...); }
+template<typename... Methods>
+Splitting<Yoshida4,Methods...> yoshida_splitting(unsigned int ns, const Methods&... m) { return Splitting<Yoshida4,Methods...>(ns,m...); }
+
+}; //namespace IVP
+
+#endif
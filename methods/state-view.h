@@ -0,0 +1,98 @@
+#ifndef _IVP_STATE_VIEW_H_
+#define _IVP_STATE_VIEW_H_
+
+#include "state.h"
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+namespace IVP {
+
+/* \brief Span-like state over memory that is not ours (a mmap'ed file, a buffer from another library...).
+ *
+ * It can be used as YType with no conversion copies: the initial state views the external buffer, the
+ * temporary states a method creates (copies and results of operators) own their own memory, and assigning
+ * to a view writes through the external buffer.
+ */
+template<typename T>
+class StateView
+{
+	std::vector<T> owned;
+	T* _data; std::size_t _size;
+	bool viewing;
+public:
+	StateView() : _data(nullptr), _size(0), viewing(false) { }
+	StateView(T* data, std::size_t size) : _data(data), _size(size), viewing(true) { }
+	//Not for StateView itself, or it would take over the copy constructor for non const lvalues
+	template<typename Container, typename = decltype(std::declval<Container&>().data()),
+		typename = typename std::enable_if<!std::is_same<Container,StateView>::value>::type>
+	explicit StateView(Container& c) : _data(c.data()), _size(c.size()), viewing(true) { }
+	explicit StateView(std::size_t size) : owned(size), _data(owned.data()), _size(size), viewing(false) { }
+
+	StateView(const StateView& that) : owned(that.begin(),that.end()), _data(owned.data()), _size(that.size()), viewing(false) { }
+	StateView(StateView&& that) : owned(std::move(that.owned)),
+		_data(that.viewing?that._data:owned.data()), _size(that._size), viewing(that.viewing) { }
+
+	/* A view keeps viewing the same buffer, so it can only take a state of its own size */
+	StateView& operator=(const StateView& that)
+	{
+		if (viewing && (that.size() != size())) throw std::invalid_argument("StateView: assigning a state of another size to a view");
+		if (viewing) std::copy(that.begin(),that.end(),begin());
+		else { owned.assign(that.begin(),that.end()); _data = owned.data(); _size = owned.size(); }
+		return (*this);
+	}
+
+	StateView& operator=(StateView&& that)
+	{
+		if (viewing || that.viewing) return (*this) = static_cast<const StateView&>(that);
+		owned = std::move(that.owned); _data = owned.data(); _size = owned.size();
+		return (*this);
+	}
+
+	bool is_view()                              const { return viewing; }
+	std::size_t size()                          const { return _size; }
+	const T* data()                             const { return _data; }
+	      T* data()                                   { return _data; }
+	const T& operator[](std::size_t i)          const { return _data[i]; }
+	      T& operator[](std::size_t i)                { return _data[i]; }
+	const T* begin()                            const { return _data; }
+	const T* end()                              const { return _data + _size; }
+	      T* begin()                                  { return _data; }
+	      T* end()                                    { return _data + _size; }
+
+	friend StateView operator+(const StateView& a, const StateView& b)
+	{	StateView sol(a.size()); for (std::size_t i = 0; i<sol.size(); ++i) sol[i] = a[i] + b[i]; return sol; }
+	friend StateView operator-(const StateView& a, const StateView& b)
+	{	StateView sol(a.size()); for (std::size_t i = 0; i<sol.size(); ++i) sol[i] = a[i] - b[i]; return sol; }
+	friend StateView operator-(const StateView& a)
+	{	StateView sol(a.size()); for (std::size_t i = 0; i<sol.size(); ++i) sol[i] = -a[i]; return sol; }
+
+	template<typename S, typename = typename std::enable_if<std::is_arithmetic<S>::value>::type>
+	friend StateView operator*(const S& s, const StateView& a)
+	{	StateView sol(a.size()); for (std::size_t i = 0; i<sol.size(); ++i) sol[i] = T(s)*a[i]; return sol; }
+	template<typename S, typename = typename std::enable_if<std::is_arithmetic<S>::value>::type>
+	friend StateView operator*(const StateView& a, const S& s)
+	{	return s*a; }
+	template<typename S, typename = typename std::enable_if<std::is_arithmetic<S>::value>::type>
+	friend StateView operator/(const StateView& a, const S& s)
+	{	StateView sol(a.size()); for (std::size_t i = 0; i<sol.size(); ++i) sol[i] = a[i]/T(s); return sol; }
+};
+
+template<typename T>
+StateView<T> state_view(T* data, std::size_t size) { return StateView<T>(data,size); }
+
+template<typename T>
+struct state_traits<StateView<T>, typename std::enable_if<fused::is_kernel_scalar<T>::value>::type> :
+	public contiguous_state_traits<StateView<T>,T>
+{
+	static StateView<T> like(const StateView<T>& v) { return StateView<T>(v.size()); }
+
+	template<typename S> using rebind = StateView<S>;
+	template<typename S> static StateView<S> cast(const StateView<T>& v) 
+	{	StateView<S> sol(v.size()); for (std::size_t i = 0; i<v.size(); ++i) sol[i] = S(v[i]); return sol; }
+};
+
+}; //namespace IVP
+
+#endif
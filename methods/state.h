@@ -0,0 +1,186 @@
+#ifndef _IVP_STATE_H_
+#define _IVP_STATE_H_
+
+#include "fused.h"
+#include <array>
+#include <vector>
+#include <memory>
+#include <cmath>
+#include <cstdlib>
+#include <type_traits>
+
+namespace IVP {
+
+/* \brief Customization point for the types that can be used as YType.
+ *
+ * Methods only need the arithmetic operators of YType, but error estimation and fused operations need to
+ * know more about it:
+ *     value_type                         the scalar type of each element
+ *     size(y)                            number of elements
+ *     at(y,i)                            element access
+ *     norm(y)                            infinity norm
+ *     linear_combination(y,{c...},k...)  y + c[0]*k[0] + c[1]*k[1] + ...
+ *     linear_combination_inplace(y,{c...},k...)  the same, but stored in y
+ *     rebind<S>, cast<S>(y)              the same kind of state with elements of type S (optional, for mixed precision)
+ *
+ * By default, anything with size() and operator[] is considered a vector of states, and arithmetic types are
+ * a single element. Contiguous containers of float and double use the fused kernels. Specialize this for your
+ * own types (see state-view.h and eigen.h).
+ */
+template<typename T, typename Enable = void>
+struct state_traits
+{
+	using value_type = typename std::decay<decltype(std::declval<const T&>()[0])>::type;
+
+	static std::size_t size(const T& v) { return v.size(); }
+	static decltype(auto) at(const T& v, std::size_t i) { return v[i]; }
+	static decltype(auto) at(T& v, std::size_t i)       { return v[i]; }
+
+	static value_type norm(const T& v)
+	{
+		value_type sol(0.0);
+		for (std::size_t i = 0; i<size(v); ++i)
+		{
+			value_type n = state_traits<value_type>::norm(at(v,i));
+			if (sol < n) sol = n;
+		}
+		return sol;
+	}
+
+	template<std::size_t N, typename... K>
+	static T linear_combination(const T& y, const double (&c)[N], const K&... k)
+	{	return fused::chained(y,c,std::array<const T*,N>{{ &k... }},std::make_index_sequence<N>()); }
+
+	template<std::size_t N, typename... K>
+	static void linear_combination_inplace(T& y, const double (&c)[N], const K&... k)
+	{	y = linear_combination(y,c,k...); }
+};
+
+template<typename T>
+struct state_traits<T, typename std::enable_if<std::is_arithmetic<T>::value>::type>
+{
+	using value_type = T;
+
+	static std::size_t size(const T& v)           { return 1; }
+	static T  at(const T& v, std::size_t i)       { return v; }
+	static T& at(T& v, std::size_t i)             { return v; }
+	static T  norm(const T& v)                    { return std::abs(v); }
+
+	template<typename S> using rebind = S;
+	template<typename S> static S cast(const T& v) { return S(v); }
+
+	template<std::size_t N, typename... K>
+	static T linear_combination(const T& y, const double (&c)[N], const K&... k)
+	{	return fused::chained(y,c,std::array<const T*,N>{{ &k... }},std::make_index_sequence<N>()); }
+
+	template<std::size_t N, typename... K>
+	static void linear_combination_inplace(T& y, const double (&c)[N], const K&... k)
+	{	y = linear_combination(y,c,k...); }
+};
+
+/* \brief Traits for contiguous storage of float or double (anything with data() and size()).
+ *
+ * Derived traits only need to say how to create an uninitialized state with the same size as another one.
+ */
+template<typename T, typename Scalar>
+struct contiguous_state_traits
+{
+	using value_type = Scalar;
+
+	static std::size_t size(const T& v)                  { return v.size(); }
+	static Scalar  at(const T& v, std::size_t i)         { return v.data()[i]; }
+	static Scalar& at(T& v, std::size_t i)               { return v.data()[i]; }
+
+	static Scalar norm(const T& v)
+	{
+		Scalar sol(0.0);
+		const Scalar* d = v.data();
+		for (std::size_t i = 0; i<v.size(); ++i) if (sol < std::abs(d[i])) sol = std::abs(d[i]);
+		return sol;
+	}
+
+	template<std::size_t N, typename... K>
+	static T linear_combination(const T& y, const double (&c)[N], const K&... k)
+	{
+		static_assert(sizeof...(K) == N, "There must be as many coefficients as terms");
+		T sol = state_traits<T>::like(y);
+		fused::axpy(sol.data(),y.data(),std::array<const Scalar*,N>{{ k.data()... }},fused::coefficients<Scalar>(c),y.size());
+		return sol;
+	}
+
+	template<std::size_t N, typename... K>
+	static void linear_combination_inplace(T& y, const double (&c)[N], const K&... k)
+	{
+		static_assert(sizeof...(K) == N, "There must be as many coefficients as terms");
+		fused::axpy(y.data(),y.data(),std::array<const Scalar*,N>{{ k.data()... }},fused::coefficients<Scalar>(c),y.size());
+	}
+};
+
+template<typename T, typename A>
+struct state_traits<std::vector<T,A>, typename std::enable_if<fused::is_kernel_scalar<T>::value>::type> :
+	public contiguous_state_traits<std::vector<T,A>,T>
+{
+	static std::vector<T,A> like(const std::vector<T,A>& v) { return std::vector<T,A>(v.size()); }
+
+	template<typename S> using rebind = std::vector<S,typename std::allocator_traits<A>::template rebind_alloc<S>>;
+	template<typename S> static rebind<S> cast(const std::vector<T,A>& v) { return rebind<S>(v.begin(),v.end()); }
+};
+
+template<typename T, std::size_t M>
+struct state_traits<std::array<T,M>, typename std::enable_if<fused::is_kernel_scalar<T>::value>::type> :
+	public contiguous_state_traits<std::array<T,M>,T>
+{
+	static std::array<T,M> like(const std::array<T,M>& v) { return std::array<T,M>(); }
+
+	template<typename S> using rebind = std::array<S,M>;
+	template<typename S> static rebind<S> cast(const std::array<T,M>& v) 
+	{	rebind<S> sol; for (std::size_t i = 0; i<M; ++i) sol[i] = S(v[i]); return sol; }
+};
+
+/* \brief y + c[0]*k[0] + c[1]*k[1] + ... Coefficients are given as a braced list:
+ *     linear_combination(y, {35.0/384.0, 500.0/1113.0}, k0, k2)
+ */
+template<typename YType, std::size_t N, typename... K>
+YType linear_combination(const YType& y, const double (&c)[N], const K&... k)
+{	return state_traits<YType>::linear_combination(y,c,k...); }
+
+/* \brief y = y + c[0]*k[0] + c[1]*k[1] + ... without creating a new state when YType allows it.
+ */
+template<typename YType, std::size_t N, typename... K>
+void linear_combination_inplace(YType& y, const double (&c)[N], const K&... k)
+{	state_traits<YType>::linear_combination_inplace(y,c,k...); }
+
+/* Weights of y0, h*f0, y1 and h*f1 in the cubic Hermite interpolant at u in [0,1] */
+struct HermiteBasis
+{
+	double h00, h10, h01, h11;
+	HermiteBasis(double u) : h00((1.0 + 2.0*u)*(1.0 - u)*(1.0 - u)), h10(u*(1.0 - u)*(1.0 - u)),
+		h01(u*u*(3.0 - 2.0*u)), h11(u*u*(u - 1.0)) { }
+};
+
+/* \brief Cubic Hermite interpolation at t0 + u*h within a step of size h from y0 to y1, f0 and f1 being the
+ * derivatives at both ends (third order accurate, whatever the order of the method).
+ */
+template<typename YType>
+YType hermite(double u, double h, const YType& y0, const YType& f0, const YType& y1, const YType& f1)
+{
+	HermiteBasis b(u);
+	return linear_combination(y0,{ b.h00 - 1.0, b.h10*h, b.h01, b.h11*h },y0,f0,y1,f1);
+}
+
+//Scalars, without going through linear_combination
+inline double hermite(double u, double h, double y0, double f0, double y1, double f1)
+{
+	HermiteBasis b(u);
+	return b.h00*y0 + b.h10*h*f0 + b.h01*y1 + b.h11*h*f1;
+}
+
+/* \brief The same state, with elements of type S.
+ */
+template<typename S, typename YType>
+typename state_traits<YType>::template rebind<S> precision_cast(const YType& y)
+{	return state_traits<YType>::template cast<S>(y); }
+
+}; //namespace IVP
+
+#endif
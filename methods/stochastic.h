@@ -0,0 +1,259 @@
+#ifndef _IVP_STOCHASTIC_H_
+#define _IVP_STOCHASTIC_H_
+
+#include "method.h"
+#include "adaptive.h"
+#include "philox.h"
+#include <vector>
+#include <utility>
+#include <cmath>
+
+namespace IVP {
+
+/* \brief Stands for the derivative of the diffusion of SDEProblems that do not give it (Milstein needs it). */
+struct NoDerivative { };
+
+/* \brief Stochastic differential equation dy = f(t,y) dt + g(t,y) dW with diagonal noise: g(t,y) is a state like
+ * y, and each element gets its own Wiener process (a scalar y, a single one). dg is the elementwise derivative of
+ * g with respect to y, only needed by Milstein.
+ *
+ * The problem carries the NormalStream its Wiener increments are drawn from: the methods start a copy of it
+ * between steps, so solving the same problem always gives the same path. For Monte Carlo, give each path its own
+ * stream id:
+ *     auto p = sde_problem(f, g, NormalStream(seed, path));
+ *
+ * As a function, it is the drift f, so deterministic methods solve the mean field problem.
+ */
+template<typename Drift, typename Diffusion, typename DDiffusion = NoDerivative>
+class SDEProblem
+{
+public:
+	Drift f; Diffusion g; DDiffusion dg;
+	NormalStream noise;
+	SDEProblem(const Drift& _f, const Diffusion& _g, const DDiffusion& _dg, const NormalStream& _noise) :
+		f(_f), g(_g), dg(_dg), noise(_noise) { }
+
+	template<typename real, typename YType>
+	YType operator()(const real& t, const YType& y) const { return f(t,y); }
+};
+
+template<typename Drift, typename Diffusion>
+SDEProblem<Drift,Diffusion> sde_problem(const Drift& f, const Diffusion& g, const NormalStream& noise = NormalStream())
+{	return SDEProblem<Drift,Diffusion>(f,g,NoDerivative(),noise); }
+
+template<typename Drift, typename Diffusion, typename DDiffusion>
+SDEProblem<Drift,Diffusion,DDiffusion> sde_problem(const Drift& f, const Diffusion& g, const DDiffusion& dg, const NormalStream& noise)
+{	return SDEProblem<Drift,Diffusion,DDiffusion>(f,g,dg,noise); }
+
+namespace stochastic {
+	/* Wiener increments over h, one per element of dW */
+	template<typename YType>
+	void draw(NormalStream& noise, YType& dW, double h)
+	{
+		double s = std::sqrt(h);
+		for (std::size_t i = 0; i<state_traits<YType>::size(dW); ++i) state_traits<YType>::at(dW,i) = s*noise();
+	}
+};
+
+/**
+ * Euler-Maruyama: y + h*f + g*dW. Strong order 1/2, weak order 1. One evaluation of f and g per step.
+ */
+class EulerMaruyama : public Method<EulerMaruyama>
+{
+public:
+	EulerMaruyama(double s) :   Method<EulerMaruyama>(s)  { }
+	EulerMaruyama(unsigned int ns) : Method<EulerMaruyama>(ns) { }
+	EulerMaruyama(int ns = 1) : Method<EulerMaruyama>((unsigned int)ns) { }
+
+	template<typename YType, typename Problem, typename real>
+	NormalStream between_steps_first(const Problem& p, const real& t_ini, const YType& y_ini, const real& t_end) const
+	{	return p.noise; }
+
+	template<typename YType, typename Problem, typename real>
+	real next(const Problem& p, const real& t, YType& y_t, const real& ht, NormalStream& noise) const
+	{
+		YType gdW = p.g(t,y_t);
+		for (std::size_t i = 0; i<state_traits<YType>::size(gdW); ++i)
+			state_traits<YType>::at(gdW,i) *= std::sqrt(double(ht))*noise();
+		linear_combination_inplace(y_t,{double(ht), 1.0},p.f(t,y_t),gdW);
+		return t+ht;
+	}
+};
+
+/**
+ * Milstein: Euler-Maruyama plus g*g'*(dW^2 - h)/2, which brings the strong order to 1 for diagonal noise. Needs
+ * dg in the SDEProblem.
+ */
+class Milstein : public Method<Milstein>
+{
+public:
+	Milstein(double s) :   Method<Milstein>(s)  { }
+	Milstein(unsigned int ns) : Method<Milstein>(ns) { }
+	Milstein(int ns = 1) : Method<Milstein>((unsigned int)ns) { }
+
+	template<typename YType, typename Problem, typename real>
+	NormalStream between_steps_first(const Problem& p, const real& t_ini, const YType& y_ini, const real& t_end) const
+	{	return p.noise; }
+
+	template<typename YType, typename Problem, typename real>
+	real next(const Problem& p, const real& t, YType& y_t, const real& ht, NormalStream& noise) const
+	{
+		using traits = state_traits<YType>;
+		YType g = p.g(t,y_t), dg = p.dg(t,y_t);
+		double s = std::sqrt(double(ht));
+		for (std::size_t i = 0; i<traits::size(g); ++i)
+		{
+			double dW = s*noise();
+			traits::at(g,i) = traits::at(g,i)*(dW + 0.5*traits::at(dg,i)*(dW*dW - double(ht)));
+		}
+		linear_combination_inplace(y_t,{double(ht), 1.0},p.f(t,y_t),g);
+		return t+ht;
+	}
+};
+
+/**
+ * Platen's derivative free scheme of strong order 1 for diagonal noise, a stochastic Runge-Kutta method that gets
+ * the Milstein term from a second evaluation of g at the support value y + h*f + g*sqrt(h):
+ *     y + h*f + g*dW + (g(support) - g)*(dW^2 - h)/(2*sqrt(h))
+ * next_embedded also gives the Euler-Maruyama step with the same increments, for AdaptiveStochasticRungeKutta.
+ */
+class StochasticRungeKutta : public Method<StochasticRungeKutta>
+{
+public:
+	StochasticRungeKutta(double s) :   Method<StochasticRungeKutta>(s)  { }
+	StochasticRungeKutta(unsigned int ns) : Method<StochasticRungeKutta>(ns) { }
+	StochasticRungeKutta(int ns = 1) : Method<StochasticRungeKutta>((unsigned int)ns) { }
+
+	template<typename YType, typename Problem, typename real>
+	NormalStream between_steps_first(const Problem& p, const real& t_ini, const YType& y_ini, const real& t_end) const
+	{	return p.noise; }
+
+	/* Step with the given increments dW, leaving the Euler-Maruyama one in other */
+	template<typename YType, typename Problem, typename real>
+	real next_embedded(const Problem& p, const real& t, YType& y_t, const real& ht, const YType& dW, YType& other) const
+	{
+		using traits = state_traits<YType>;
+		double s = std::sqrt(double(ht));
+		YType f = p.f(t,y_t), g = p.g(t,y_t);
+		YType g_support = p.g(t,linear_combination(y_t,{double(ht), s},f,g));
+		for (std::size_t i = 0; i<traits::size(g); ++i)
+		{
+			double w = traits::at(dW,i);
+			traits::at(g_support,i) = (traits::at(g_support,i) - traits::at(g,i))*(w*w - double(ht))/(2.0*s);
+			traits::at(g,i) *= w;
+		}
+		linear_combination_inplace(y_t,{double(ht), 1.0},f,g);
+		other = y_t;
+		linear_combination_inplace(y_t,{1.0},g_support);
+		return t+ht;
+	}
+
+	template<typename YType, typename Problem, typename real>
+	real next(const Problem& p, const real& t, YType& y_t, const real& ht, NormalStream& noise) const
+	{
+		YType dW = y_t, other;
+		stochastic::draw(noise,dW,double(ht));
+		return next_embedded(p,t,y_t,ht,dW,other);
+	}
+};
+
+/* \brief The Wiener path of an adaptive SDE solve: increments over intervals already drawn but not used yet
+ * (those of rejected steps), and the stream for the rest.
+ *
+ * A rejected step can not just draw its increment again with a smaller step, as that would select the paths
+ * where the error is small. Its increment is given back, and the next attempts take their part of it from the
+ * Brownian bridge: over the first s of an interval of length L and increment W, the increment is normal with
+ * mean W*s/L and variance s*(L - s)/L, and the rest of the interval stays pending.
+ */
+template<typename YType, typename real>
+class BrownianPath
+{
+	NormalStream noise;
+	std::vector<std::pair<real,YType>> pending; //Next interval at the back
+public:
+	BrownianPath(const NormalStream& _noise = NormalStream()) : noise(_noise) { }
+
+	/* Increment over the next h, shaped like y */
+	YType take(const real& h, const YType& y)
+	{
+		using traits = state_traits<YType>;
+		YType dW = y;
+		for (std::size_t i = 0; i<traits::size(dW); ++i) traits::at(dW,i) = 0.0;
+		real left = h;
+		while ((left > real(0)) && !pending.empty())
+		{
+			std::pair<real,YType>& next = pending.back();
+			if (next.first <= left*real(1.0 + 1.e-12))
+			{
+				for (std::size_t i = 0; i<traits::size(dW); ++i) traits::at(dW,i) += traits::at(next.second,i);
+				left -= next.first; pending.pop_back();
+			}
+			else
+			{
+				double L = double(next.first), s = double(left), sd = std::sqrt(s*(L - s)/L);
+				for (std::size_t i = 0; i<traits::size(dW); ++i)
+				{
+					double part = traits::at(next.second,i)*s/L + sd*noise();
+					traits::at(dW,i) += part; traits::at(next.second,i) -= part;
+				}
+				next.first -= left; left = real(0);
+			}
+		}
+		if (left > real(0))
+		{
+			double sd = std::sqrt(double(left));
+			for (std::size_t i = 0; i<traits::size(dW); ++i) traits::at(dW,i) += sd*noise();
+		}
+		return dW;
+	}
+
+	/* The increment of a rejected step, which becomes the next one */
+	void give_back(const real& h, YType&& dW) { pending.emplace_back(h,std::move(dW)); }
+};
+
+/**
+ * StochasticRungeKutta with step size control: the error of a step is the difference with the Euler-Maruyama
+ * step (the Milstein term), measured by Estimator and adapted by AdaptationStrategy as in Adaptive. Rejected
+ * steps keep their Wiener increments (see BrownianPath), so the solution still follows the same path.
+ */
+template<typename Estimator = ErrorEstimator, typename AdaptationStrategy = StandardStrategy>
+class AdaptiveStochasticRungeKutta : public Method<AdaptiveStochasticRungeKutta<Estimator,AdaptationStrategy>>
+{
+	double _tolerance; double min_step;
+	StochasticRungeKutta base;
+	Estimator estimator;
+	AdaptationStrategy adaptation;
+public:
+	AdaptiveStochasticRungeKutta(unsigned int ns = 1, double tol = 1.e-3, double _min_step = 0.0) :
+		Method<AdaptiveStochasticRungeKutta<Estimator,AdaptationStrategy>>(ns), _tolerance(tol), min_step(_min_step) { }
+
+	double tolerance() const { return _tolerance; }
+	void set_tolerance(double t) { _tolerance = t; }
+
+	template<typename YType, typename Problem, typename real>
+	BrownianPath<YType,real> between_steps_first(const Problem& p, const real& t_ini, const YType& y_ini, const real& t_end) const
+	{	return BrownianPath<YType,real>(p.noise); }
+
+	template<typename YType, typename Problem, typename real>
+	real next(const Problem& p, const real& t, YType& y_t, real& ht, BrownianPath<YType,real>& path) const
+	{
+		while (true)
+		{
+			YType dW = path.take(ht,y_t), y = y_t, other;
+			real t_next = base.next_embedded(p,t,y,ht,dW,other);
+			real error = real(static_cast<const Estimator&>(estimator).estimate_error(y,other));
+			if ((error <= real(tolerance())) || (ht <= min_step))
+			{
+				ht = adaptation.new_step(ht,error,real(tolerance()));
+				y_t = std::move(y);
+				return t_next;
+			}
+			path.give_back(ht,std::move(dW));
+			ht = adaptation.new_step(ht,error,real(tolerance()));
+		}
+	}
+};
+
+}; //namespace IVP
+
+#endif
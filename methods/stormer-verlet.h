@@ -0,0 +1,39 @@
+#ifndef _IVP_STORMER_VERLET_H_
+#define _IVP_STORMER_VERLET_H_
+
+#include "method.h"
+#include "second-order.h"
+
+namespace IVP
+{
+
+/**
+ * Stormer-Verlet (velocity form) for y'' = f(t,y) over SecondOrderState. Second order, symplectic and time
+ * reversible, with a single evaluation of f per step: the acceleration at the end of a step is kept for the
+ * next one.
+ */
+class StormerVerlet : public Method<StormerVerlet>
+{
+public:
+	StormerVerlet(double s) :   Method<StormerVerlet>(s)  { }
+	StormerVerlet(unsigned int ns) : Method<StormerVerlet>(ns) { }
+	StormerVerlet(int ns = 1) : Method<StormerVerlet>((unsigned int)ns) { }
+
+	template<typename YType, typename Function, typename real>
+	YType between_steps_first(const Function& f, const real& t_ini, const SecondOrderState<YType>& x_ini, const real& t_end) const
+	{	return f(t_ini, x_ini.y); }
+
+	template<typename YType, typename Function, typename real>
+	real next(const Function& f, const real& t, SecondOrderState<YType>& x, const real& h, YType& a) const
+	{
+		YType v_half = x.v + (real(0.5)*h)*a;
+		x.y = x.y + h*v_half;
+		a = f(t+h, x.y);
+		x.v = v_half + (real(0.5)*h)*a;
+		return t+h;
+	}
+};
+
+};
+
+#endif
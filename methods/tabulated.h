@@ -0,0 +1,181 @@
+#ifndef _IVP_TABULATED_H_
+#define _IVP_TABULATED_H_
+
+#include "state.h"
+#include <vector>
+#include <string>
+#include <memory>
+#include <fstream>
+#include <stdexcept>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define IVP_TABULATED_MMAP
+#endif
+
+namespace IVP {
+
+enum class Interpolation { Linear, Cubic };
+
+/* \brief A function of time given by samples (t_i, v_i), i.e. a coefficient of linear_problem taken from a
+ * measured time series:
+ *     auto c1 = TabulatedFunction("c1.tab", Interpolation::Cubic);
+ *     auto f = linear_problem(c1, c0);
+ *
+ * Tables are files (see write_tabulated) that are memory mapped, so opening them takes no time whatever their
+ * size, and only the pages that are used are ever read. Samples are stored as (t_i, v_i) pairs, so a lookup
+ * touches a single cache line. Each copy keeps a cursor at the last interval found: monotone queries, such as the
+ * stages of successive steps, are amortized O(1), and jumps fall back to a binary search. Copies share the
+ * table, but not the cursor, so give each thread its own copy.
+ *
+ * The interpolation is linear or cubic (Hermite with centered slopes, C1, exact for quadratics between the inner
+ * points of uniform samples). Outside of the table the function is constant. Times must be increasing.
+ */
+class TabulatedFunction
+{
+public:
+	/* File layout: magic, number of samples (uint64_t), then the samples as (double t, double v) pairs, in the
+	 * byte order of the machine.
+	 */
+	static constexpr char magic[8] = { 'I','V','P','T','A','B','1','\0' };
+	static constexpr std::size_t header_size = 16;
+
+private:
+	class Table
+	{
+		std::vector<double> owned;
+		void* map = nullptr; std::size_t map_size = 0;
+	public:
+		const double* samples = nullptr; std::size_t count = 0;
+
+		Table(std::vector<double>&& pairs) : owned(std::move(pairs)), samples(owned.data()), count(owned.size()/2) { }
+
+		Table(const std::string& file)
+		{
+			std::uint64_t n = 0;
+#ifdef IVP_TABULATED_MMAP
+			int fd = ::open(file.c_str(),O_RDONLY|O_CLOEXEC);
+			if (fd < 0) throw std::runtime_error("Can not open " + file);
+			struct stat st;
+			if ((::fstat(fd,&st) != 0) || (std::size_t(st.st_size) < header_size)) { ::close(fd); throw std::runtime_error("Not a table: " + file); }
+			map_size = std::size_t(st.st_size);
+			map = ::mmap(nullptr,map_size,PROT_READ,MAP_SHARED,fd,0);
+			::close(fd);
+			if (map == MAP_FAILED) { map = nullptr; throw std::runtime_error("Can not map " + file); }
+#ifdef MADV_SEQUENTIAL
+			::madvise(map,map_size,MADV_SEQUENTIAL);
+#endif
+			const char* bytes = static_cast<const char*>(map);
+			std::memcpy(&n,bytes + 8,sizeof(n));
+			if ((std::memcmp(bytes,magic,8) != 0) || (map_size < header_size + 2*sizeof(double)*n))
+			{	::munmap(map,map_size); throw std::runtime_error("Not a table: " + file); }
+			samples = reinterpret_cast<const double*>(bytes + header_size);
+#else
+			std::ifstream in(file,std::ios::binary);
+			char m[8];
+			if (!(in.read(m,8) && in.read(reinterpret_cast<char*>(&n),sizeof(n))) || (std::memcmp(m,magic,8) != 0))
+				throw std::runtime_error("Not a table: " + file);
+			owned.resize(2*n);
+			if (!in.read(reinterpret_cast<char*>(owned.data()),std::streamsize(2*sizeof(double)*n))) throw std::runtime_error("Not a table: " + file);
+			samples = owned.data();
+#endif
+			count = std::size_t(n);
+			if (count == 0) throw std::runtime_error("Empty table: " + file);
+		}
+
+		~Table()
+		{
+#ifdef IVP_TABULATED_MMAP
+			if (map) ::munmap(map,map_size);
+#endif
+		}
+
+		Table(const Table&) = delete;
+		Table& operator=(const Table&) = delete;
+	};
+
+	std::shared_ptr<const Table> table;
+	Interpolation interpolation;
+	mutable std::size_t cursor = 0;
+
+	double t(std::size_t i) const { return table->samples[2*i]; }
+	double v(std::size_t i) const { return table->samples[2*i + 1]; }
+
+	/* i such that t(i) <= x < t(i+1), with 0 <= i <= size() - 2 */
+	std::size_t locate(double x) const
+	{
+		const std::size_t last = table->count - 2;
+		std::size_t i = cursor;
+		if (x >= t(i))
+		{
+			for (unsigned int k = 0; (k < 4) && (i < last); ++k, ++i) if (x < t(i + 1)) return cursor = i;
+			if (i >= last) return cursor = last;
+			std::size_t a = i, b = last + 1; //t(a) <= x
+			while (b - a > 1) { std::size_t m = (a + b)/2; if (t(m) <= x) a = m; else b = m; }
+			return cursor = a;
+		}
+		std::size_t a = 0, b = i; //x < t(b)
+		while (b - a > 1) { std::size_t m = (a + b)/2; if (t(m) <= x) a = m; else b = m; }
+		return cursor = a;
+	}
+
+	/* Centered slope at sample i (one sided at the ends) */
+	double slope(std::size_t i) const
+	{
+		std::size_t a = (i > 0)?(i - 1):i, b = (i + 1 < table->count)?(i + 1):i;
+		return (v(b) - v(a))/(t(b) - t(a));
+	}
+
+public:
+	TabulatedFunction(const std::string& file, Interpolation _interpolation = Interpolation::Linear) :
+		table(std::make_shared<const Table>(file)), interpolation(_interpolation) { }
+
+	/* From samples in memory */
+	TabulatedFunction(const std::vector<double>& ts, const std::vector<double>& vs, Interpolation _interpolation = Interpolation::Linear) :
+		interpolation(_interpolation)
+	{
+		if (ts.empty() || (ts.size() != vs.size())) throw std::invalid_argument("TabulatedFunction needs as many values as times");
+		std::vector<double> pairs(2*ts.size());
+		for (std::size_t i = 0; i<ts.size(); ++i) { pairs[2*i] = ts[i]; pairs[2*i + 1] = vs[i]; }
+		table = std::make_shared<const Table>(std::move(pairs));
+	}
+
+	std::size_t size()  const { return table->count; }
+	double t_begin()    const { return t(0); }
+	double t_end()      const { return t(table->count - 1); }
+
+	double operator()(double x) const
+	{
+		if (table->count == 1 || x <= t_begin()) return v(0);
+		if (x >= t_end()) return v(table->count - 1);
+		std::size_t i = locate(x);
+		double h = t(i + 1) - t(i), u = (x - t(i))/h;
+		if (interpolation == Interpolation::Linear) return v(i) + u*(v(i + 1) - v(i));
+		return hermite(u,h,v(i),slope(i),v(i + 1),slope(i + 1));
+	}
+};
+
+/* \brief Writes samples in the layout that TabulatedFunction maps. */
+inline void write_tabulated(const std::string& file, const std::vector<double>& ts, const std::vector<double>& vs)
+{
+	if (ts.empty() || (ts.size() != vs.size())) throw std::invalid_argument("write_tabulated needs as many values as times");
+	std::ofstream out(file,std::ios::binary);
+	std::uint64_t n = ts.size();
+	out.write(TabulatedFunction::magic,8);
+	out.write(reinterpret_cast<const char*>(&n),sizeof(n));
+	for (std::size_t i = 0; i<ts.size(); ++i)
+	{
+		out.write(reinterpret_cast<const char*>(&ts[i]),sizeof(double));
+		out.write(reinterpret_cast<const char*>(&vs[i]),sizeof(double));
+	}
+	if (!out) throw std::runtime_error("Can not write " + file);
+}
+
+}; //namespace IVP
+
+#endif
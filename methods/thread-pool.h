@@ -0,0 +1,214 @@
+#ifndef _IVP_THREAD_POOL_H_
+#define _IVP_THREAD_POOL_H_
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <vector>
+#include <functional>
+#include <exception>
+#include <memory>
+#include <algorithm>
+
+namespace IVP {
+
+/* \brief Fixed set of worker threads for the parallel parts of some methods (i.e. the columns of BulirschStoer).
+ *
+ * parallel_for(n,f) runs f(0)...f(n-1) and returns when all of them are done. The calling thread takes part, so a
+ * pool with no workers runs everything serially on the caller, and a pool of p workers uses p+1 threads. Work is
+ * handed out one index at a time, so list the most expensive tasks first. If some f(i) throws, the first exception
+ * is rethrown by parallel_for once every task has finished.
+ *
+ * The constructor takes the number of workers. Methods keep the pool through a std::shared_ptr, so that copies
+ * of the method share the threads. Calls from several threads at the same time are allowed (they queue), but not
+ * from within a task.
+ */
+class ThreadPool
+{
+	std::vector<std::thread> workers;
+	std::deque<std::function<void()>> tasks;
+	std::mutex mutex;
+	std::condition_variable available;
+	bool stopping;
+
+	void work()
+	{
+		while (true)
+		{
+			std::function<void()> task;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				available.wait(lock, [this] () { return stopping || !tasks.empty(); });
+				if (tasks.empty()) return;
+				task = std::move(tasks.front()); tasks.pop_front();
+			}
+			task();
+		}
+	}
+
+	struct Batch
+	{
+		std::atomic<std::size_t> next{0};
+		std::size_t helpers_left;
+		std::mutex mutex;
+		std::condition_variable done;
+		std::exception_ptr error;
+	};
+
+	template<typename F>
+	static void drain(Batch& batch, std::size_t n, const F& f)
+	{
+		for (std::size_t i = batch.next++; i<n; i = batch.next++)
+		{
+			try { f(i); }
+			catch (...)
+			{
+				std::lock_guard<std::mutex> lock(batch.mutex);
+				if (!batch.error) batch.error = std::current_exception();
+			}
+		}
+	}
+
+public:
+	explicit ThreadPool(std::size_t threads) : stopping(false)
+	{
+		workers.reserve(threads);
+		for (std::size_t i = 0; i<threads; ++i) workers.emplace_back([this] () { work(); });
+	}
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+		available.notify_all();
+		for (std::thread& w : workers) w.join();
+	}
+
+	/* Threads that run tasks, counting the caller of parallel_for */
+	std::size_t size() const { return workers.size() + 1; }
+
+	template<typename F>
+	void parallel_for(std::size_t n, const F& f)
+	{
+		if (n == 0) return;
+		Batch batch;
+		std::size_t helpers = std::min(workers.size(), n - 1);
+		batch.helpers_left = helpers;
+		if (helpers > 0)
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				for (std::size_t h = 0; h<helpers; ++h)
+					tasks.emplace_back([&batch, n, &f] ()
+					{
+						drain(batch,n,f);
+						std::lock_guard<std::mutex> lock(batch.mutex);
+						if (--batch.helpers_left == 0) batch.done.notify_one();
+					});
+			}
+			available.notify_all();
+		}
+		drain(batch,n,f);
+		{
+			//Helpers reference batch and f, so wait for all of them (not only for the tasks)
+			std::unique_lock<std::mutex> lock(batch.mutex);
+			batch.done.wait(lock, [&batch] () { return batch.helpers_left == 0; });
+		}
+		if (batch.error) std::rethrow_exception(batch.error);
+	}
+};
+
+/* \brief A single helper thread for one task at a time, with a low latency handoff (i.e. the full step of the
+ * step doubling in Adaptive, that runs next to the two half steps).
+ *
+ * post(f) publishes f through an atomic and returns; wait() spins until it is done and rethrows what it threw.
+ * While idle the helper spins, then yields and, after a long while without work, sleeps on a condition variable
+ * (only then does post take a mutex, to wake it up). f must live until wait() returns.
+ */
+class SpinningWorker
+{
+	enum : int { idle, posted, done, stopping };
+	std::atomic<int> state;
+	std::atomic<bool> parked;
+	void (*task)(void*); void* argument;
+	std::exception_ptr error;
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::thread thread;
+
+	void work()
+	{
+		unsigned int spins = 0;
+		while (true)
+		{
+			int s = state.load(std::memory_order_acquire);
+			if (s == stopping) return;
+			if (s == posted)
+			{
+				try { task(argument); }
+				catch (...) { error = std::current_exception(); }
+				state.store(done, std::memory_order_release);
+				spins = 0;
+			}
+			else if (++spins < 64) continue;
+			else if (spins < (1u<<16)) std::this_thread::yield();
+			else
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				parked = true;
+				wake.wait(lock, [this] () { int s = state.load(); return (s == posted) || (s == stopping); });
+				parked = false; spins = 0;
+			}
+		}
+	}
+
+	void publish(int s)
+	{
+		state.store(s);
+		if (parked.load())
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			wake.notify_one();
+		}
+	}
+
+public:
+	SpinningWorker() : state(idle), parked(false), task(nullptr), argument(nullptr), thread([this] () { work(); }) { }
+	SpinningWorker(const SpinningWorker&) = delete;
+	SpinningWorker& operator=(const SpinningWorker&) = delete;
+	~SpinningWorker() { publish(stopping); thread.join(); }
+
+	template<typename F>
+	void post(F& f)
+	{
+		task = [] (void* p) { (*static_cast<F*>(p))(); };
+		argument = &f; error = nullptr;
+		publish(posted);
+	}
+
+	void wait()
+	{
+		unsigned int spins = 0;
+		while (state.load(std::memory_order_acquire) != done) if (++spins >= 64) std::this_thread::yield();
+		state.store(idle, std::memory_order_relaxed);
+		if (error) std::rethrow_exception(error);
+	}
+};
+
+/* A pool with as many threads (caller included) as given, or one per hardware thread if 0 */
+inline std::shared_ptr<ThreadPool> thread_pool(std::size_t threads = 0)
+{
+	if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+	return std::make_shared<ThreadPool>(threads - 1);
+}
+
+}; //namespace IVP
+
+#endif
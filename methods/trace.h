@@ -0,0 +1,222 @@
+#ifndef _IVP_TRACE_H_
+#define _IVP_TRACE_H_
+
+/* \brief Timeline of an integration: every step (Steps), every attempt of Adaptive and, through traced(f), every
+ * evaluation of f, with their start, duration, time, step size, error and whether they were accepted.
+ *
+ * Only compiled with IVP_TRACING defined (cmake -DIVP_TRACING=ON, or per target). Otherwise the hooks are empty
+ * macros and nothing here exists, so there is no overhead at all.
+ *
+ * Each thread appends to its own buffer (no locks or atomics per event, only when a thread records its first
+ * event). Write the trace once the traced threads are done:
+ *   IVP::trace::write_chrome_trace("trace.json")   for chrome://tracing or https://ui.perfetto.dev
+ * and, on Linux, IVP::trace::open_markers() also writes each event as an ftrace marker (perf record -e ftrace:print,
+ * or trace-cmd), which lines them up with the rest of the system (i.e. other processes of an ensemble).
+ */
+#ifdef IVP_TRACING
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <chrono>
+#include <string>
+#include <fstream>
+#include <ostream>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <algorithm>
+#include <type_traits>
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace IVP { namespace trace {
+
+struct Event
+{
+	const char* name;
+	std::uint64_t start, duration; //ns
+	double t, h, error;
+	int accepted;                  //-1 if it does not apply
+};
+
+class ThreadBuffer
+{
+public:
+	unsigned int id;
+	std::vector<Event> events;
+	std::size_t dropped = 0;
+	ThreadBuffer(unsigned int _id) : id(_id) { events.reserve(1<<12); }
+};
+
+class Registry
+{
+	std::mutex mutex;
+	std::vector<std::unique_ptr<ThreadBuffer>> buffers; //Kept after their threads end
+public:
+	const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+	std::size_t max_events_per_thread = std::size_t(1)<<24;
+	int marker_fd = -1;
+
+	static Registry& instance() { static Registry r; return r; }
+
+	ThreadBuffer* add()
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		buffers.emplace_back(new ThreadBuffer((unsigned int)buffers.size()));
+		return buffers.back().get();
+	}
+
+	template<typename F>
+	void for_each(const F& f)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		for (const auto& b : buffers) f(*b);
+	}
+};
+
+inline ThreadBuffer& buffer()
+{
+	thread_local ThreadBuffer* b = Registry::instance().add();
+	return *b;
+}
+
+inline std::uint64_t now()
+{	return std::uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - Registry::instance().epoch).count()); }
+
+inline void record(const Event& e)
+{
+	ThreadBuffer& b = buffer();
+	if (b.events.size() < Registry::instance().max_events_per_thread) b.events.push_back(e);
+	else ++b.dropped;
+#ifdef __linux__
+	int fd = Registry::instance().marker_fd;
+	if (fd >= 0)
+	{
+		char line[160];
+		int n = std::snprintf(line,sizeof(line),"ivp %s t=%.17g h=%.17g error=%g accepted=%d duration_ns=%llu\n",
+			e.name,e.t,e.h,e.error,e.accepted,(unsigned long long)e.duration);
+		if (n > 0) (void)::write(fd,line,std::size_t(std::min(n,int(sizeof(line)) - 1)));
+	}
+#endif
+}
+
+/* Records an event from its construction to its destruction */
+class Scope
+{
+	Event e;
+public:
+	Scope(const char* name, double t, double h) : e{ name, now(), 0, t, h, std::numeric_limits<double>::quiet_NaN(), -1 } { }
+	~Scope() { e.duration = now() - e.start; record(e); }
+
+	void end_at(double t_end) { e.h = t_end - e.t; }
+	void result(double error, bool accepted) { e.error = error; e.accepted = accepted?1:0; }
+};
+
+/* f, recording each evaluation as an "f" event */
+template<typename Function>
+class Traced
+{
+	Function f; const char* name;
+public:
+	Traced(const Function& _f, const char* _name) : f(_f), name(_name) { }
+
+	template<typename real, typename YType>
+	auto operator()(const real& t, const YType& y) const -> decltype(f(t,y))
+	{
+		Scope s(name,double(t),0.0);
+		return f(t,y);
+	}
+};
+
+template<typename Function>
+Traced<std::decay_t<Function>> traced(const Function& f, const char* name = "f") { return Traced<std::decay_t<Function>>(f,name); }
+
+inline void clear() { Registry::instance().for_each([] (ThreadBuffer& b) { b.events.clear(); b.dropped = 0; }); }
+
+inline std::size_t size()
+{
+	std::size_t n = 0;
+	Registry::instance().for_each([&n] (ThreadBuffer& b) { n += b.events.size(); });
+	return n;
+}
+
+/* Chrome trace event format: complete ("X") events, times in microseconds, one tid per thread */
+inline void write_chrome_trace(std::ostream& out)
+{
+	out<<"{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+	bool first = true;
+	char number[32];
+	auto json = [&number] (double x) -> const char*
+	{
+		if (x != x) return "null";
+		std::snprintf(number,sizeof(number),"%.17g",x);
+		return number;
+	};
+	Registry::instance().for_each([&] (ThreadBuffer& b)
+	{
+		for (const Event& e : b.events)
+		{
+			out<<(first?"":",")<<"\n{\"name\":\""<<e.name<<"\",\"ph\":\"X\",\"pid\":1,\"tid\":"<<b.id
+			   <<",\"ts\":"<<json(1.e-3*double(e.start))<<",\"dur\":"<<json(1.e-3*double(e.duration))
+			   <<",\"args\":{\"t\":"<<json(e.t)<<",\"h\":"<<json(e.h);
+			if (e.error == e.error) out<<",\"error\":"<<json(e.error);
+			if (e.accepted >= 0) out<<",\"accepted\":"<<(e.accepted?"true":"false");
+			out<<"}}";
+			first = false;
+		}
+		if (b.dropped > 0)
+		{
+			out<<(first?"":",")<<"\n{\"name\":\"dropped events\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":"<<b.id
+			   <<",\"ts\":0,\"args\":{\"count\":"<<b.dropped<<"}}";
+			first = false;
+		}
+	});
+	out<<"\n]}\n";
+}
+
+inline bool write_chrome_trace(const std::string& file)
+{
+	std::ofstream out(file);
+	write_chrome_trace(out);
+	return bool(out);
+}
+
+/* Also writes every event as an ftrace marker, if the file can be opened (usually needs privileges) */
+inline bool open_markers(const std::string& file = "/sys/kernel/tracing/trace_marker")
+{
+#ifdef __linux__
+	int fd = ::open(file.c_str(),O_WRONLY|O_CLOEXEC);
+	if (fd < 0) return false;
+	Registry::instance().marker_fd = fd;
+	return true;
+#else
+	return false;
+#endif
+}
+
+inline void close_markers()
+{
+#ifdef __linux__
+	int& fd = Registry::instance().marker_fd;
+	if (fd >= 0) { ::close(fd); fd = -1; }
+#endif
+}
+
+}; }; //namespace IVP::trace
+
+#define IVP_TRACE_SCOPE(var, name, t, h)   ::IVP::trace::Scope var(name, double(t), double(h))
+#define IVP_TRACE_END_AT(var, t_end)       var.end_at(double(t_end))
+#define IVP_TRACE_RESULT(var, error, ok)   var.result(double(error), ok)
+
+#else
+
+#define IVP_TRACE_SCOPE(var, name, t, h)
+#define IVP_TRACE_END_AT(var, t_end)
+#define IVP_TRACE_RESULT(var, error, ok)
+
+#endif
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef _IVP_VECTOR_OPERATORS_H_
+#define _IVP_VECTOR_OPERATORS_H_
+
+#include <vector>
+#include <type_traits>
+
+/* Elementwise operators to use std::vector as YType. They are found by ordinary lookup, not by ADL (std::vector
+ * is in namespace std), so they must be declared before including ivp.h. Nothing includes them for you: the
+ * ivp-any-solver library uses them in its own translation unit only.
+ */
+template<typename T>
+std::vector<T> operator+(const std::vector<T>& a, const std::vector<T>& b)
+{	std::vector<T> sol(a.size()); for (std::size_t i = 0; i<a.size(); ++i) sol[i] = a[i] + b[i]; return sol; }
+
+template<typename T>
+std::vector<T> operator-(const std::vector<T>& a, const std::vector<T>& b)
+{	std::vector<T> sol(a.size()); for (std::size_t i = 0; i<a.size(); ++i) sol[i] = a[i] - b[i]; return sol; }
+
+template<typename T>
+std::vector<T> operator-(const std::vector<T>& a)
+{	std::vector<T> sol(a.size()); for (std::size_t i = 0; i<a.size(); ++i) sol[i] = -a[i]; return sol; }
+
+template<typename S, typename T, typename = typename std::enable_if<std::is_arithmetic<S>::value>::type>
+std::vector<T> operator*(const S& s, const std::vector<T>& a)
+{	std::vector<T> sol(a.size()); for (std::size_t i = 0; i<a.size(); ++i) sol[i] = T(s)*a[i]; return sol; }
+
+template<typename S, typename T, typename = typename std::enable_if<std::is_arithmetic<S>::value>::type>
+std::vector<T> operator*(const std::vector<T>& a, const S& s)
+{	return s*a; }
+
+template<typename S, typename T, typename = typename std::enable_if<std::is_arithmetic<S>::value>::type>
+std::vector<T> operator/(const std::vector<T>& a, const S& s)
+{	std::vector<T> sol(a.size()); for (std::size_t i = 0; i<a.size(); ++i) sol[i] = a[i]/T(s); return sol; }
+
+#endif
@@ -0,0 +1,18 @@
+/* Explicit instantiations of AnySolver and its factory for the usual states: the ivp-any-solver library.
+ * std::vector<double> uses the elementwise operators of methods/vector-operators.h. Its users only see the extern
+ * template declarations in any-solver.h, which do not need them.
+ */
+#include "methods/vector-operators.h"
+#include <ivp.h>
+
+namespace IVP {
+
+template class AnySolver<float>;
+template class AnySolver<double>;
+template class AnySolver<std::vector<double>>;
+
+template AnySolver<float> any_solver<float>(const std::string&, unsigned int, double);
+template AnySolver<double> any_solver<double>(const std::string&, unsigned int, double);
+template AnySolver<std::vector<double>> any_solver<std::vector<double>>(const std::string&, unsigned int, double);
+
+}; //namespace IVP